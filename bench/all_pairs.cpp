@@ -0,0 +1,79 @@
+#include <cstdint>
+#include <random>
+
+#include "AllShortestPathBF.hpp"
+#include "DiGraph.hpp"
+#include "FloydWarshall.hpp"
+
+#include "benchmark/benchmark.h"
+
+// Random graph with _order nodes and an average out degree of 16.
+// Node potentials make some edges negative without creating
+// negative cycles.
+static DiGraph<double> getRandomGraph(const int _order) {
+    std::mt19937 gen(_order);
+    std::uniform_int_distribution<Graph::Node> nodeDist(0, _order - 1);
+    std::uniform_int_distribution<int> weightDist(1, 100);
+    DiGraph<double> graph(_order);
+    for (Graph::Node u = 0; u < _order; ++u) {
+        for (int i = 0; i < 16; ++i) {
+            const auto v = nodeDist(gen);
+            if (u != v && !graph.hasEdge(u, v)) {
+                graph.addEdge(u, v,
+                    weightDist(gen) + 40.0 * (u % 3) - 40.0 * (v % 3));
+            }
+        }
+    }
+    return graph;
+}
+
+template <typename W>
+static void BM_floydwarshall(benchmark::State& state) {
+    const auto graph = getRandomGraph(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        FloydWarshall<W> floydWarshall(graph);
+        floydWarshall.computeAllShortestPaths();
+        benchmark::DoNotOptimize(floydWarshall.getDistance(0, 0));
+    }
+}
+
+static void BM_johnson(benchmark::State& state) {
+    auto graph = getRandomGraph(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        AllShortestPathBellmanFord<DiGraph<double>> allPairs(graph);
+        allPairs.getAllShortestPathsJohnson();
+        benchmark::DoNotOptimize(allPairs.getDistance()(0, 0));
+    }
+}
+
+static void BM_bellmanford(benchmark::State& state) {
+    auto graph = getRandomGraph(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        AllShortestPathBellmanFord<DiGraph<double>> allPairs(graph);
+        allPairs.getAllShortestPaths();
+        benchmark::DoNotOptimize(allPairs.getDistance()(0, 0));
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_floydwarshall, double)
+    ->RangeMultiplier(2)
+    ->Range(128, 2048)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_floydwarshall, std::int32_t)
+    ->RangeMultiplier(2)
+    ->Range(128, 2048)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_johnson)
+    ->RangeMultiplier(2)
+    ->Range(128, 2048)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_bellmanford)
+    ->RangeMultiplier(2)
+    ->Range(128, 256)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,107 @@
+#include <random>
+
+#include "DiGraph.hpp"
+#include "ShortestPathBF.hpp"
+
+#include "benchmark/benchmark.h"
+
+using BellmanFord = ShortestPathBellmanFord<DiGraph<double>>;
+using Variant = Graph::Path (BellmanFord::*)(Graph::Node, Graph::Node);
+
+// Random graph with _order nodes and an average out degree of 4.
+// Node potentials make some edges negative without creating
+// negative cycles.
+static DiGraph<double> getRandomGraph(const int _order) {
+    std::mt19937 gen(_order);
+    std::uniform_int_distribution<Graph::Node> nodeDist(0, _order - 1);
+    std::uniform_int_distribution<int> weightDist(1, 100);
+    DiGraph<double> graph(_order);
+    for (Graph::Node u = 0; u < _order; ++u) {
+        for (int i = 0; i < 4; ++i) {
+            const auto v = nodeDist(gen);
+            if (u != v && !graph.hasEdge(u, v)) {
+                graph.addEdge(u, v,
+                    weightDist(gen) + 40.0 * (u % 3) - 40.0 * (v % 3));
+            }
+        }
+    }
+    return graph;
+}
+
+static void runVariant(benchmark::State& state, const Variant _variant) {
+    const auto graph = getRandomGraph(static_cast<int>(state.range(0)));
+    BellmanFord bellmanFord(graph);
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<Graph::Node> nodeDist(
+        0, graph.getOrder() - 1);
+    for (auto _ : state) {
+        try {
+            benchmark::DoNotOptimize(
+                (bellmanFord.*_variant)(nodeDist(gen), nodeDist(gen)));
+        } catch (const BellmanFord::NegativeCycleException&) {
+            state.SkipWithError("Spurious negative cycle");
+            break;
+        }
+    }
+}
+
+static void BM_bellmanford_SPFA(benchmark::State& state) {
+    runVariant(state, &BellmanFord::getShortestPath);
+}
+
+static void BM_bellmanford_sweeps(benchmark::State& state) {
+    const auto graph = getRandomGraph(static_cast<int>(state.range(0)));
+    BellmanFord bellmanFord(graph);
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<Graph::Node> nodeDist(
+        0, graph.getOrder() - 1);
+    for (auto _ : state) {
+        bellmanFord.computeShortestPathTreeBySweeps(nodeDist(gen));
+    }
+}
+
+static void BM_bellmanford_v1(benchmark::State& state) {
+    runVariant(state, &BellmanFord::getShortestPath_v1);
+}
+
+static void BM_bellmanford_v2(benchmark::State& state) {
+    runVariant(state, &BellmanFord::getShortestPath_v2);
+}
+
+static void BM_bellmanford_v3(benchmark::State& state) {
+    runVariant(state, &BellmanFord::getShortestPath_v3);
+}
+
+static void BM_bellmanford_YenFirst(benchmark::State& state) {
+    runVariant(state, &BellmanFord::getShortestPath_YenFirst);
+}
+
+static void BM_bellmanford_YenFirst_doublevector(benchmark::State& state) {
+    runVariant(state, &BellmanFord::getShortestPath_YenFirst_doublevector);
+}
+
+static void BM_bellmanford_YenFirst_partition(benchmark::State& state) {
+    runVariant(state, &BellmanFord::getShortestPath_YenFirst_partition);
+}
+
+static void BM_bellmanford_YenSecond_partition(benchmark::State& state) {
+    runVariant(state, &BellmanFord::getShortestPath_YenSecond_partition);
+}
+
+BENCHMARK(BM_bellmanford_SPFA)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_bellmanford_sweeps)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_bellmanford_v1)->RangeMultiplier(4)->Range(64, 1024);
+BENCHMARK(BM_bellmanford_v2)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_bellmanford_v3)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_bellmanford_YenFirst)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_bellmanford_YenFirst_doublevector)
+    ->RangeMultiplier(4)
+    ->Range(64, 4096);
+BENCHMARK(BM_bellmanford_YenFirst_partition)
+    ->RangeMultiplier(4)
+    ->Range(64, 4096);
+BENCHMARK(BM_bellmanford_YenSecond_partition)
+    ->RangeMultiplier(4)
+    ->Range(64, 4096);
+
+BENCHMARK_MAIN();
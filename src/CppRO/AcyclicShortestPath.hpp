@@ -0,0 +1,240 @@
+#ifndef ACYCLICSHORTESTPATH_HPP
+#define ACYCLICSHORTESTPATH_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Graph.hpp"
+
+/**
+ * Single and multi source shortest paths of a directed acyclic graph, in
+ * O(n + m), by relaxing the out edges of each node in topological order.
+ *
+ * Any weight is allowed, negative ones included. Longest paths are computed
+ * with DistanceComparator = std::greater<weight_type>.
+ *
+ * The topological order is computed once by the constructor. A search from s
+ * starts at the position of s in it, since the nodes before s can not be
+ * reached. The multi source search walks the order once for all the sources:
+ * the distances of a node to every source are contiguous, so relaxing an edge
+ * for all the sources is a single vectorized loop.
+ *
+ * Unreachable nodes have a distance of getUnreachedDistance(). For integer
+ * weights, it is half of the extreme value, so the weight of a path must stay
+ * below it.
+ */
+template <typename G,
+    typename DistanceComparator = std::less<typename G::weight_type>>
+class AcyclicShortestPath {
+  public:
+    using weight_type = typename G::weight_type;
+
+    explicit AcyclicShortestPath(
+        const G& _graph, DistanceComparator _distComp = DistanceComparator());
+
+    /**
+     * \brief Returns false if the graph has a cycle, in which case the
+     * searches must not be used
+     */
+    bool isAcyclic() const {
+        return static_cast<int>(m_topologicalOrder.size())
+               == m_graph->getOrder();
+    }
+
+    /**
+     * \brief Returns the nodes of the graph in topological order
+     */
+    const std::vector<Graph::Node>& getTopologicalOrder() const {
+        return m_topologicalOrder;
+    }
+
+    weight_type getUnreachedDistance() const { return m_unreached; }
+
+    /**
+     * \brief Compute the shortest path tree rooted at _s
+     */
+    void computeShortestPathTree(const Graph::Node _s) {
+        computeShortestPathTree(_s, EdgeWeight{m_graph});
+    }
+
+    template <typename WeightFunction>
+    void computeShortestPathTree(Graph::Node _s, WeightFunction _wf);
+
+    weight_type getDistance(const Graph::Node _u) const {
+        return m_distance[_u];
+    }
+
+    Graph::Node getParent(const Graph::Node _u) const { return m_parent[_u]; }
+
+    /**
+     * \brief Write the path from the root of the last search to _t into
+     * _path. Returns false, with an empty _path, if _t is not reachable.
+     */
+    bool getPath(Graph::Node _t, Graph::Path& _path) const;
+
+    /**
+     * \brief Compute the distances from every node of _sources to every node
+     * in a single walk of the topological order
+     * The distance from the i-th source to u is then given by
+     * getDistance(i, u). No parent is kept.
+     */
+    void computeDistances(const std::vector<Graph::Node>& _sources) {
+        computeDistances(_sources, EdgeWeight{m_graph});
+    }
+
+    template <typename WeightFunction>
+    void computeDistances(
+        const std::vector<Graph::Node>& _sources, WeightFunction _wf);
+
+    weight_type getDistance(const std::size_t _i, const Graph::Node _u) const {
+        return m_distances[static_cast<std::size_t>(_u) * m_nbSources + _i];
+    }
+
+  private:
+    struct EdgeWeight {
+        G const* graph;
+        weight_type operator()(
+            const Graph::Node _u, const Graph::Node _v) const {
+            return graph->getEdgeWeight(_u, _v);
+        }
+    };
+
+    static constexpr weight_type infinity() {
+        if constexpr (std::is_floating_point_v<weight_type>) {
+            return std::numeric_limits<weight_type>::max();
+        } else {
+            return std::numeric_limits<weight_type>::max() / 2;
+        }
+    }
+
+    G const* m_graph;
+    DistanceComparator m_distComp;
+    weight_type m_unreached;
+    std::vector<Graph::Node> m_topologicalOrder{};
+    // Position of each node in m_topologicalOrder
+    std::vector<int> m_positions;
+    std::vector<weight_type> m_distance;
+    std::vector<Graph::Node> m_parent;
+    // Distances of the multi source search, grouped by node
+    std::size_t m_nbSources{0};
+    std::vector<weight_type> m_distances{};
+};
+
+template <typename G, typename DistanceComparator>
+AcyclicShortestPath<G, DistanceComparator>::AcyclicShortestPath(
+    const G& _graph, DistanceComparator _distComp)
+    : m_graph(&_graph)
+    , m_distComp(std::move(_distComp))
+    , m_unreached(
+          m_distComp(weight_type(0), infinity()) ? infinity() : -infinity())
+    , m_positions(_graph.getOrder(), -1)
+    , m_distance(_graph.getOrder(), m_unreached)
+    , m_parent(_graph.getOrder(), -1) {
+    // Kahn's algorithm, using the order as the queue
+    std::vector<int> inDegrees(_graph.getOrder(), 0);
+    for (Graph::Node u = 0; u < _graph.getOrder(); ++u) {
+        for (const auto v : _graph.getNeighbors(u)) {
+            ++inDegrees[v];
+        }
+    }
+    m_topologicalOrder.reserve(_graph.getOrder());
+    for (Graph::Node u = 0; u < _graph.getOrder(); ++u) {
+        if (inDegrees[u] == 0) {
+            m_topologicalOrder.push_back(u);
+        }
+    }
+    for (std::size_t i = 0; i < m_topologicalOrder.size(); ++i) {
+        const auto u = m_topologicalOrder[i];
+        m_positions[u] = static_cast<int>(i);
+        for (const auto v : _graph.getNeighbors(u)) {
+            if (--inDegrees[v] == 0) {
+                m_topologicalOrder.push_back(v);
+            }
+        }
+    }
+}
+
+template <typename G, typename DistanceComparator>
+template <typename WeightFunction>
+void AcyclicShortestPath<G, DistanceComparator>::computeShortestPathTree(
+    const Graph::Node _s, WeightFunction _wf) {
+    assert(isAcyclic());
+    std::fill(m_distance.begin(), m_distance.end(), m_unreached);
+    std::fill(m_parent.begin(), m_parent.end(), -1);
+    m_distance[_s] = 0;
+    m_parent[_s] = _s;
+    for (auto ite = m_topologicalOrder.begin() + m_positions[_s];
+         ite != m_topologicalOrder.end(); ++ite) {
+        const auto u = *ite;
+        if (m_parent[u] == -1) {
+            continue;
+        }
+        for (const auto v : m_graph->getNeighbors(u)) {
+            const weight_type distT = m_distance[u] + _wf(u, v);
+            if (m_parent[v] == -1 || m_distComp(distT, m_distance[v])) {
+                m_distance[v] = distT;
+                m_parent[v] = u;
+            }
+        }
+    }
+}
+
+template <typename G, typename DistanceComparator>
+bool AcyclicShortestPath<G, DistanceComparator>::getPath(
+    const Graph::Node _t, Graph::Path& _path) const {
+    _path.clear();
+    if (m_parent[_t] == -1) {
+        return false;
+    }
+    for (Graph::Node u = _t; _path.empty() || _path.back() != u;
+         u = m_parent[u]) {
+        _path.push_back(u);
+    }
+    std::reverse(_path.begin(), _path.end());
+    return true;
+}
+
+template <typename G, typename DistanceComparator>
+template <typename WeightFunction>
+void AcyclicShortestPath<G, DistanceComparator>::computeDistances(
+    const std::vector<Graph::Node>& _sources, WeightFunction _wf) {
+    assert(isAcyclic());
+    m_nbSources = _sources.size();
+    m_distances.assign(m_nbSources * m_graph->getOrder(), m_unreached);
+    if (_sources.empty()) {
+        return;
+    }
+    int first = m_graph->getOrder();
+    for (std::size_t i = 0; i < m_nbSources; ++i) {
+        const auto s = static_cast<std::size_t>(_sources[i]);
+        m_distances[s * m_nbSources + i] = 0;
+        first = std::min(first, m_positions[_sources[i]]);
+    }
+    const weight_type unreached = m_unreached;
+    const DistanceComparator distComp = m_distComp;
+    for (auto ite = m_topologicalOrder.begin() + first;
+         ite != m_topologicalOrder.end(); ++ite) {
+        const auto u = *ite;
+        const weight_type* distanceU =
+            m_distances.data() + static_cast<std::size_t>(u) * m_nbSources;
+        for (const auto v : m_graph->getNeighbors(u)) {
+            const weight_type weight = _wf(u, v);
+            weight_type* distanceV =
+                m_distances.data() + static_cast<std::size_t>(v) * m_nbSources;
+#pragma omp simd
+            for (std::size_t i = 0; i < m_nbSources; ++i) {
+                const weight_type distance = distanceU[i] + weight;
+                const bool improves = distanceU[i] != unreached
+                                      && distComp(distance, distanceV[i]);
+                distanceV[i] = improves ? distance : distanceV[i];
+            }
+        }
+    }
+}
+
+#endif
@@ -2,14 +2,30 @@
 #define ALLSHORTESTPATHBF_HPP
 
 #include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <variant>
+#include <vector>
 
+#include <omp.h>
+
+#include "EdgeRelaxation.hpp"
 #include "Graph.hpp"
 #include "Matrix.hpp"
+#include "ShortestPath.hpp"
 #include "utility.hpp"
 
 template <typename G>
 class AllShortestPathBellmanFord {
   public:
+    /**
+     * Next hop matrix stored with the narrowest signed integer type that can
+     * hold every node, see getCompactNextHops
+     */
+    using CompactNextHops = std::variant<Matrix<std::int8_t>,
+        Matrix<std::int16_t>, Matrix<std::int32_t>>;
+
     explicit AllShortestPathBellmanFord(G& _graph)
         : m_graph(_graph)
         , m_distance([&]() {
@@ -53,12 +69,166 @@ class AllShortestPathBellmanFord {
         }
     }
 
+    /**
+     * \brief Fill the distance and parent matrices with Johnson's algorithm
+     * A Bellman-Ford from a virtual source linked to every node gives
+     * potentials h such that w(u, v) + h(u) - h(v) >= 0, then one Dijkstra per
+     * source runs on these reweighted edges, spread over _nbThreads threads.
+     * This is O(nm log n) instead of O(n^2 m) for getAllShortestPaths.
+     * Returns false, leaving the matrices unchanged, if the graph has a
+     * negative cycle.
+     */
+    bool getAllShortestPathsJohnson(int _nbThreads = omp_get_max_threads());
+
     const Matrix<double>& getDistance() const { return m_distance; }
 
+    const Matrix<Graph::Node>& getParent() const { return m_parent; }
+
+    /**
+     * \brief Write the shortest path from _s to _t into _path, which keeps its
+     * capacity. Returns false, with an empty path, if _t can not be reached.
+     */
+    bool getPath(Graph::Node _s, Graph::Node _t, Graph::Path& _path) const;
+
+    /**
+     * \brief Returns the node following _s on the shortest path to _t, _s if
+     * _s == _t and -1 if _t can not be reached
+     * Goes up the shortest path tree of _s from _t, so it is linear in the
+     * number of hops; use getNextHops for repeated queries.
+     */
+    Graph::Node getNextHop(Graph::Node _s, Graph::Node _t) const;
+
+    /**
+     * \brief Returns the next hop of every pair, in the format of loadNextHop
+     * Every node must fit in T.
+     */
+    template <typename T>
+    Matrix<T> getNextHops() const;
+
+    CompactNextHops getCompactNextHops() const;
+
   private:
     G& m_graph;
     Matrix<double> m_distance;
     Matrix<Graph::Node> m_parent;
 };
 
+template <typename G>
+bool AllShortestPathBellmanFord<G>::getAllShortestPathsJohnson(
+    const int _nbThreads) {
+    const int order = m_graph.getOrder();
+    // Distances from the virtual source start at 0 for every node
+    const auto edges = EdgeArrays<double>::fromGraph(m_graph);
+    std::vector<double> potential(order, 0.0);
+    std::vector<Graph::Node> parent(order, -1);
+    bool anyChange = true;
+    for (int i = 0; i <= order && anyChange; ++i) {
+        anyChange = relaxEdges(edges, potential, parent);
+    }
+    if (anyChange) {
+        return false;
+    }
+
+    const auto reducedWeight = [&](const Graph::Node _u, const Graph::Node _v) {
+        // Rounding errors must not make a weight negative
+        return std::max(
+            0.0, m_graph.getEdgeWeight(_u, _v) + potential[_u] - potential[_v]);
+    };
+#pragma omp parallel num_threads(_nbThreads)
+    {
+        ShortestPath<G> shortestPath(m_graph);
+#pragma omp for schedule(dynamic)
+        for (Graph::Node s = 0; s < order; ++s) {
+            shortestPath.computeShortestPathTree(s, reducedWeight);
+            for (Graph::Node t = 0; t < order; ++t) {
+                if (shortestPath.getParent(t) == -1) {
+                    m_distance(s, t) = std::numeric_limits<double>::max();
+                    m_parent(s, t) = -1;
+                } else {
+                    m_distance(s, t) = shortestPath.getDistance(t)
+                                       - potential[s] + potential[t];
+                    m_parent(s, t) = shortestPath.getParent(t);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+template <typename G>
+bool AllShortestPathBellmanFord<G>::getPath(
+    const Graph::Node _s, const Graph::Node _t, Graph::Path& _path) const {
+    _path.clear();
+    if (m_parent(_s, _t) == -1) {
+        return false;
+    }
+    Graph::Node node = _t;
+    while (node != _s) {
+        _path.push_back(node);
+        node = m_parent(_s, node);
+    }
+    _path.push_back(_s);
+    std::reverse(_path.begin(), _path.end());
+    return true;
+}
+
+template <typename G>
+Graph::Node AllShortestPathBellmanFord<G>::getNextHop(
+    const Graph::Node _s, const Graph::Node _t) const {
+    if (_s == _t || m_parent(_s, _t) == -1) {
+        return m_parent(_s, _t);
+    }
+    Graph::Node node = _t;
+    while (m_parent(_s, node) != _s) {
+        node = m_parent(_s, node);
+    }
+    return node;
+}
+
+template <typename G>
+template <typename T>
+Matrix<T> AllShortestPathBellmanFord<G>::getNextHops() const {
+    const int order = m_graph.getOrder();
+    assert(order - 1 <= std::numeric_limits<T>::max());
+    // Next hops are shared along the branches of the shortest path tree of
+    // each source, so every pair is only solved once. -2 marks the pairs that
+    // are not solved yet.
+    Matrix<T> nextHops(order, order, -2);
+    std::vector<Graph::Node> branch;
+    for (Graph::Node s = 0; s < order; ++s) {
+        nextHops(s, s) = static_cast<T>(s);
+        for (Graph::Node t = 0; t < order; ++t) {
+            Graph::Node node = t;
+            while (nextHops(s, node) == -2 && m_parent(s, node) != s
+                   && m_parent(s, node) != -1) {
+                branch.push_back(node);
+                node = m_parent(s, node);
+            }
+            T nextHop = nextHops(s, node);
+            if (nextHop == -2) {
+                nextHop = static_cast<T>(m_parent(s, node) == s ? node : -1);
+                nextHops(s, node) = nextHop;
+            }
+            for (const auto u : branch) {
+                nextHops(s, u) = nextHop;
+            }
+            branch.clear();
+        }
+    }
+    return nextHops;
+}
+
+template <typename G>
+typename AllShortestPathBellmanFord<G>::CompactNextHops
+AllShortestPathBellmanFord<G>::getCompactNextHops() const {
+    const int order = m_graph.getOrder();
+    if (order - 1 <= std::numeric_limits<std::int8_t>::max()) {
+        return getNextHops<std::int8_t>();
+    }
+    if (order - 1 <= std::numeric_limits<std::int16_t>::max()) {
+        return getNextHops<std::int16_t>();
+    }
+    return getNextHops<std::int32_t>();
+}
+
 #endif
@@ -29,6 +29,7 @@ class BinaryHeap {
         : m_maxSize(_maxSize)
         , m_array(static_cast<Node*>(malloc(sizeof(Node) * _maxSize)))
         , m_handle(static_cast<Handle*>(malloc(sizeof(Handle) * _maxSize)))
+        , m_freeHandles(static_cast<int*>(malloc(sizeof(int) * _maxSize)))
         , m_nbElements(0)
         , m_comparator(std::move(_comparator)) {}
 
@@ -41,6 +42,7 @@ class BinaryHeap {
         }
         free(m_array);
         free(m_handle);
+        free(m_freeHandles);
     }
 
     // Copy
@@ -48,12 +50,17 @@ class BinaryHeap {
         : m_maxSize(_o.m_maxSize)
         , m_array(static_cast<Node*>(malloc(sizeof(Node) * m_maxSize)))
         , m_handle(static_cast<Handle*>(malloc(sizeof(Handle) * m_maxSize)))
+        , m_freeHandles(static_cast<int*>(malloc(sizeof(int) * m_maxSize)))
         , m_nbElements(_o.m_nbElements)
+        , m_nbUsedHandles(_o.m_nbUsedHandles)
+        , m_nbFreeHandles(_o.m_nbFreeHandles)
         , m_comparator(_o.m_comparator) {
         for (int i = 0; i < m_maxSize; ++i) {
             new (m_array + i) Node(_o.m_array[i]);
             new (m_handle + i) Handle(_o.m_handle[i]);
         }
+        std::copy(
+            _o.m_freeHandles, _o.m_freeHandles + m_nbFreeHandles, m_freeHandles);
     }
 
     BinaryHeap& operator=(const BinaryHeap& _o) {
@@ -62,12 +69,18 @@ class BinaryHeap {
             static_cast<Node*>(realloc(m_array, sizeof(Node) * m_maxSize));
         m_handle =
             static_cast<Handle*>(realloc(m_handle, sizeof(Handle) * m_maxSize));
+        m_freeHandles =
+            static_cast<int*>(realloc(m_freeHandles, sizeof(int) * m_maxSize));
         m_nbElements = _o.m_nbElements;
+        m_nbUsedHandles = _o.m_nbUsedHandles;
+        m_nbFreeHandles = _o.m_nbFreeHandles;
         m_comparator = _o.m_comparator;
         for (int i = 0; i < m_maxSize; ++i) {
             new (m_array + i) Node(_o.m_array[i]);
             new (m_handle + i) Handle(_o.m_handle[i]);
         }
+        std::copy(
+            _o.m_freeHandles, _o.m_freeHandles + m_nbFreeHandles, m_freeHandles);
         return *this;
     }
 
@@ -76,17 +89,24 @@ class BinaryHeap {
         : m_maxSize(std::move(_bh.m_maxSize))
         , m_array(std::move(_bh.m_array))
         , m_handle(std::move(_bh.m_handle))
+        , m_freeHandles(std::move(_bh.m_freeHandles))
         , m_nbElements(std::move(_bh.m_nbElements))
+        , m_nbUsedHandles(std::move(_bh.m_nbUsedHandles))
+        , m_nbFreeHandles(std::move(_bh.m_nbFreeHandles))
         , m_comparator(std::move(_bh.m_comparator)) {
         _bh.m_array = nullptr;
         _bh.m_handle = nullptr;
+        _bh.m_freeHandles = nullptr;
     }
 
     BinaryHeap& operator=(BinaryHeap&& _bh) noexcept {
         std::swap(m_maxSize, _bh.m_maxSize);
         std::swap(m_handle, _bh.m_handle);
         std::swap(m_array, _bh.m_array);
+        std::swap(m_freeHandles, _bh.m_freeHandles);
         std::swap(m_nbElements, _bh.m_nbElements);
+        std::swap(m_nbUsedHandles, _bh.m_nbUsedHandles);
+        std::swap(m_nbFreeHandles, _bh.m_nbFreeHandles);
         m_comparator = std::move(_bh.m_comparator);
         return *this;
     }
@@ -96,11 +116,15 @@ class BinaryHeap {
     bool empty() const { return m_nbElements == 0; }
 
     Handle* push(const T& object) {
-        Handle* h = m_handle + m_nbElements;
+        // Handles still owned by elements in the heap must not be reused, so
+        // take a released one first and only then a never used one.
+        Handle* h = m_handle
+                    + (m_nbFreeHandles > 0 ? m_freeHandles[--m_nbFreeHandles]
+                                           : m_nbUsedHandles++);
         new (h) Handle(m_nbElements);
 
         Node* n = m_array + m_nbElements;
-        new (n) Node(object, m_handle + m_nbElements);
+        new (n) Node(object, h);
 
         if (m_nbElements > 0) {
             int obj = m_nbElements;
@@ -119,7 +143,11 @@ class BinaryHeap {
         return h;
     }
 
-    void clear() { m_nbElements = 0; }
+    void clear() {
+        m_nbElements = 0;
+        m_nbUsedHandles = 0;
+        m_nbFreeHandles = 0;
+    }
 
     void pop() {
         if (m_nbElements > 0) {
@@ -147,6 +175,8 @@ class BinaryHeap {
                     break;
                 }
             }
+            m_freeHandles[m_nbFreeHandles++] =
+                static_cast<int>(m_array[m_nbElements].handle - m_handle);
             m_array[m_nbElements].~Node();
         }
     }
@@ -203,7 +233,10 @@ class BinaryHeap {
     int m_maxSize;
     Node* m_array;
     Handle* m_handle;
+    int* m_freeHandles;
     int m_nbElements;
+    int m_nbUsedHandles{0};
+    int m_nbFreeHandles{0};
     Comparator m_comparator;
 };
 #endif
@@ -4,7 +4,6 @@
 #include <CppRO/cplex_utility.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/range.hpp>
-#include <boost/range/combine.hpp>
 #include <vector>
 
 namespace CppRO {
@@ -16,10 +15,54 @@ class CompactConstrainedShortestPathModel {
 
     std::vector<IloRange> m_flowConservationConstraints;
     IloRange m_delayConstraint;
+    // Objective, only added to the model by the first cost update
+    IloObjective m_objective;
+
+    // Coefficients currently in the model, to skip the unchanged ones
+    std::vector<double> m_delays;
+    std::vector<double> m_costs;
+    // Buffers of the changed coefficients, sent to CPLEX in one call
+    IloNumVarArray m_changedVars;
+    IloNumArray m_changedCoefs;
 
     std::size_t m_currentSource{0};
     std::size_t m_currentTarget{0};
 
+    /**
+     * Stage the coefficient of the edge if it differs from the one in the
+     * model
+     */
+    void stageCoef(std::vector<double>& _coefs, const std::size_t _edge,
+        const double _value) {
+        if (_coefs[_edge] != _value) {
+            _coefs[_edge] = _value;
+            m_changedVars.add(m_flowVars[_edge]);
+            m_changedCoefs.add(_value);
+        }
+    }
+
+    /**
+     * Send the staged coefficients to _extractable and returns their number
+     */
+    template <typename Extractable>
+    std::size_t flushCoefs(Extractable& _extractable) {
+        const auto nbChanged =
+            static_cast<std::size_t>(m_changedVars.getSize());
+        if (nbChanged > 0) {
+            _extractable.setLinearCoefs(m_changedVars, m_changedCoefs);
+            m_changedVars.clear();
+            m_changedCoefs.clear();
+        }
+        return nbChanged;
+    }
+
+    IloObjective& getUpdatableObjective() {
+        if (m_objective.getImpl() == nullptr) {
+            m_objective = IloAdd(m_model, IloMinimize(m_model.getEnv()));
+        }
+        return m_objective;
+    }
+
   public:
     /**
      * Build a model according to the graph and the delay of the link
@@ -43,8 +86,56 @@ class CompactConstrainedShortestPathModel {
         m_flowConservationConstraints[m_currentSource].setBounds(1.0, 1.0);
     }
 
+    /**
+     * Set the delay of every edge, in the order of the flow variables. Only
+     * the coefficients that changed are updated in the model, and their
+     * number is returned.
+     */
     template <typename DelayRange>
-    void setDelays(const DelayRange& _delayRange);
+    std::size_t setDelays(const DelayRange& _delayRange);
+
+    /**
+     * Set the delays of the edges of _edgeRange only, in O(size of
+     * _edgeRange)
+     */
+    template <typename EdgeRange, typename DelayRange>
+    std::size_t setDelays(
+        const EdgeRange& _edgeRange, const DelayRange& _delayRange);
+
+    void setDelay(const std::size_t _edge, const double _delay) {
+        stageCoef(m_delays, _edge, _delay);
+        flushCoefs(m_delayConstraint);
+    }
+
+    /**
+     * Set the cost of every edge in the minimization objective of the model,
+     * which is created by the first call. Only the coefficients that changed
+     * are updated, and their number is returned.
+     */
+    template <typename CostRange>
+    std::size_t setCosts(const CostRange& _costRange);
+
+    /**
+     * Set the costs of the edges of _edgeRange only, in O(size of
+     * _edgeRange), e.g. the arcs whose reduced cost changed after a dual
+     * update
+     */
+    template <typename EdgeRange, typename CostRange>
+    std::size_t setCosts(
+        const EdgeRange& _edgeRange, const CostRange& _costRange);
+
+    void setCost(const std::size_t _edge, const double _cost) {
+        stageCoef(m_costs, _edge, _cost);
+        flushCoefs(getUpdatableObjective());
+    }
+
+    /**
+     * Returns the objective set by setCosts, or an empty handle if the costs
+     * were never set
+     */
+    [[nodiscard]] const IloObjective& getObjective() const {
+        return m_objective;
+    }
 
     /**
      * Returns the built model
@@ -95,18 +186,51 @@ CompactConstrainedShortestPathModel::CompactConstrainedShortestPathModel(
     }())
     , m_delayConstraint(
           IloAdd(m_model, IloRange(m_model.getEnv(), -IloInfinity, 0.0)))
+    , m_delays(num_edges(_graph), 0.0)
+    , m_costs(num_edges(_graph), 0.0)
+    , m_changedVars(m_model.getEnv())
+    , m_changedCoefs(m_model.getEnv())
 
 {}
 
 template <typename DelayRange>
-void CompactConstrainedShortestPathModel::setDelays(
+std::size_t CompactConstrainedShortestPathModel::setDelays(
     const DelayRange& _delayRange) {
-    IloExpr arcSumExpr(m_model.getEnv());
-    for (const auto& [delay, var] : boost::combine(_delayRange, m_flowVars)) {
-        arcSumExpr += static_cast<IloNum>(delay)
-                      * var; // cast to IloNum to avoid ambiguous overload
+    std::size_t edge = 0;
+    for (const auto& delay : _delayRange) {
+        stageCoef(m_delays, edge++, static_cast<double>(delay));
+    }
+    return flushCoefs(m_delayConstraint);
+}
+
+template <typename EdgeRange, typename DelayRange>
+std::size_t CompactConstrainedShortestPathModel::setDelays(
+    const EdgeRange& _edgeRange, const DelayRange& _delayRange) {
+    auto delay = std::begin(_delayRange);
+    for (const auto edge : _edgeRange) {
+        stageCoef(m_delays, edge, static_cast<double>(*delay++));
+    }
+    return flushCoefs(m_delayConstraint);
+}
+
+template <typename CostRange>
+std::size_t CompactConstrainedShortestPathModel::setCosts(
+    const CostRange& _costRange) {
+    std::size_t edge = 0;
+    for (const auto& cost : _costRange) {
+        stageCoef(m_costs, edge++, static_cast<double>(cost));
+    }
+    return flushCoefs(getUpdatableObjective());
+}
+
+template <typename EdgeRange, typename CostRange>
+std::size_t CompactConstrainedShortestPathModel::setCosts(
+    const EdgeRange& _edgeRange, const CostRange& _costRange) {
+    auto cost = std::begin(_costRange);
+    for (const auto edge : _edgeRange) {
+        stageCoef(m_costs, edge, static_cast<double>(*cost++));
     }
-    m_delayConstraint.setExpr(arcSumExpr);
+    return flushCoefs(getUpdatableObjective());
 }
 
 } // namespace CppRO
@@ -0,0 +1,110 @@
+#ifndef CPPRO_CONSTRAINEDSHORTESTPATHBATCH
+#define CPPRO_CONSTRAINEDSHORTESTPATHBATCH
+
+#include <CppRO/ConstrainedShortestPathLabeling.hpp>
+#include <CppRO/ConstrainedShortestPathNetwork.hpp>
+#include <array>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include <omp.h>
+
+namespace CppRO {
+
+/**
+ * Constrained shortest path query from source to target within
+ * maxResources, the first resource being the delay
+ **/
+template <std::size_t NbResources = 1>
+struct ConstrainedShortestPathQuery {
+    std::size_t source;
+    std::size_t target;
+    std::array<double, NbResources> maxResources;
+};
+
+/**
+ * Constrained shortest paths of many node pairs on the same network.
+ *
+ * The bounds to each distinct target are computed once for all the queries
+ * towards it, then the queries are spread over the threads, each thread
+ * solving them with its own labeling and label pool. Solvers and bounds are
+ * kept between batches, so the next batches reuse their memory.
+ **/
+template <std::size_t NbResources = 1>
+class BatchConstrainedShortestPath {
+  public:
+    using Network = ConstrainedShortestPathNetwork<NbResources>;
+    using Bounds = ConstrainedShortestPathBounds<NbResources>;
+    using Query = ConstrainedShortestPathQuery<NbResources>;
+    using Path = ConstrainedPath<NbResources>;
+
+    explicit BatchConstrainedShortestPath(const Network& _network)
+        : m_network(&_network)
+        , m_targetBounds(_network.getNbNodes(), NONE) {}
+
+    /**
+     * Solve every query with the current costs and resources. Returns, in the
+     * order of _queries, the constrained shortest path of each query or
+     * nothing if it is infeasible.
+     */
+    std::vector<std::optional<Path>> solve(const std::vector<Query>& _queries,
+        int _nbThreads = omp_get_max_threads());
+
+  private:
+    static constexpr std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+    Network const* m_network;
+    // Index in m_bounds of the bounds to each target of the batch
+    std::vector<std::size_t> m_targetBounds;
+    std::vector<std::size_t> m_targets{};
+    std::vector<Bounds> m_bounds{};
+    std::vector<LabelingConstrainedShortestPath<NbResources>> m_solvers{};
+};
+
+template <std::size_t NbResources>
+std::vector<std::optional<ConstrainedPath<NbResources>>>
+BatchConstrainedShortestPath<NbResources>::solve(
+    const std::vector<Query>& _queries, const int _nbThreads) {
+    for (const auto& query : _queries) {
+        if (m_targetBounds[query.target] == NONE) {
+            m_targetBounds[query.target] = m_targets.size();
+            m_targets.push_back(query.target);
+        }
+    }
+    if (m_bounds.size() < m_targets.size()) {
+        m_bounds.resize(m_targets.size());
+    }
+    while (m_solvers.size() < static_cast<std::size_t>(_nbThreads)) {
+        m_solvers.emplace_back(*m_network);
+    }
+
+    std::vector<std::optional<Path>> paths(_queries.size());
+#pragma omp parallel num_threads(_nbThreads)
+    {
+        auto& solver =
+            m_solvers[static_cast<std::size_t>(omp_get_thread_num())];
+#pragma omp for schedule(dynamic)
+        for (std::size_t i = 0; i < m_targets.size(); ++i) {
+            m_bounds[i].computeToTarget(*m_network, m_targets[i]);
+        }
+#pragma omp for schedule(dynamic)
+        for (std::size_t i = 0; i < _queries.size(); ++i) {
+            const auto& query = _queries[i];
+            solver.setNodePair(query.source, query.target);
+            solver.setMaxResources(query.maxResources);
+            if (solver.solve(m_bounds[m_targetBounds[query.target]])) {
+                paths[i] = solver.getPath();
+            }
+        }
+    }
+
+    for (const auto target : m_targets) {
+        m_targetBounds[target] = NONE;
+    }
+    m_targets.clear();
+    return paths;
+}
+
+} // namespace CppRO
+#endif
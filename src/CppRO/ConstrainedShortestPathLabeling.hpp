@@ -0,0 +1,521 @@
+#ifndef CPPRO_CONSTRAINEDSHORTESTPATHLABELING
+#define CPPRO_CONSTRAINEDSHORTESTPATHLABELING
+
+#include <CppRO/ConstrainedShortestPathNetwork.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace CppRO {
+
+/**
+ * Returns true if a partial path of cost _cost1 using _resources1 is at least
+ * as good as one of cost _cost2 using _resources2 on every criterion
+ **/
+template <std::size_t NbResources>
+bool dominates(const double _cost1,
+    const std::array<double, NbResources>& _resources1, const double _cost2,
+    const std::array<double, NbResources>& _resources2) {
+    if (_cost1 > _cost2) {
+        return false;
+    }
+    for (std::size_t r = 0; r < NbResources; ++r) {
+        if (_resources1[r] > _resources2[r]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Labels of a labeling search, with the Pareto front of each node.
+ * reset() keeps the memory, so a pool reused across queries stops allocating
+ * once it has grown to the largest search.
+ **/
+template <std::size_t NbResources = 1>
+class LabelPool {
+  public:
+    using Resources = std::array<double, NbResources>;
+
+    static constexpr std::size_t NONE =
+        std::numeric_limits<std::size_t>::max();
+
+    /**
+     * Partial path given by its cost, its resource consumption and the label
+     * it extends through edge. Root labels have neither.
+     */
+    struct Label {
+        double cost;
+        Resources resources;
+        std::size_t node;
+        std::size_t pred;
+        std::size_t edge;
+        bool dominated;
+    };
+
+    void reset(const std::size_t _nbNodes) {
+        m_labels.clear();
+        m_nodeLabels.resize(_nbNodes);
+        for (auto& labels : m_nodeLabels) {
+            labels.clear();
+        }
+        m_nbDominated = 0;
+    }
+
+    /**
+     * Add the label to its node unless it is dominated, removing the labels
+     * of the node it dominates. Returns false if it was discarded.
+     */
+    bool add(const Label& _label);
+
+    [[nodiscard]] const Label& operator[](const std::size_t _id) const {
+        return m_labels[_id];
+    }
+
+    [[nodiscard]] std::size_t size() const { return m_labels.size(); }
+
+    /**
+     * Labels of _u that are not dominated
+     */
+    [[nodiscard]] const std::vector<std::size_t>& getNodeLabels(
+        const std::size_t _u) const {
+        return m_nodeLabels[_u];
+    }
+
+    /**
+     * Number of labels discarded by dominance since the last reset
+     */
+    [[nodiscard]] std::size_t getNbDominated() const { return m_nbDominated; }
+
+  private:
+    std::vector<Label> m_labels{};
+    std::vector<std::vector<std::size_t>> m_nodeLabels{};
+    std::size_t m_nbDominated{0};
+};
+
+template <std::size_t NbResources>
+bool LabelPool<NbResources>::add(const Label& _label) {
+    auto& labels = m_nodeLabels[_label.node];
+    for (std::size_t i = 0; i < labels.size();) {
+        auto& other = m_labels[labels[i]];
+        if (dominates(other.cost, other.resources, _label.cost,
+                _label.resources)) {
+            ++m_nbDominated;
+            return false;
+        }
+        if (dominates(_label.cost, _label.resources, other.cost,
+                other.resources)) {
+            other.dominated = true;
+            ++m_nbDominated;
+            labels[i] = labels.back();
+            labels.pop_back();
+        } else {
+            ++i;
+        }
+    }
+    labels.push_back(m_labels.size());
+    m_labels.push_back(_label);
+    return true;
+}
+
+/**
+ * Exact resource constrained shortest path by label setting, without a
+ * solver.
+ *
+ * Labels are partial paths from the source. They are expanded by increasing
+ * cost plus the lower bound of the cost to the target, so the first label of
+ * the target to be expanded is optimal. Labels that can not reach the target
+ * within the resource limits or below the cost of the best path found so far
+ * are never created, and a label dominated by another label of the same node
+ * is discarded.
+ *
+ * \tparam NbResources Number of resources constrained along the path, the
+ * first one being the delay
+ **/
+template <std::size_t NbResources = 1>
+class LabelingConstrainedShortestPath {
+  public:
+    using Network = ConstrainedShortestPathNetwork<NbResources>;
+    using Bounds = ConstrainedShortestPathBounds<NbResources>;
+    using Resources = typename Network::Resources;
+    using Path = ConstrainedPath<NbResources>;
+
+    explicit LabelingConstrainedShortestPath(const Network& _network)
+        : m_network(&_network) {
+        m_maxResources.fill(std::numeric_limits<double>::infinity());
+    }
+
+    /**
+     * Set the source and destination of the constrained shortest path
+     */
+    void setNodePair(const std::size_t _source, const std::size_t _target) {
+        m_source = _source;
+        m_target = _target;
+    }
+
+    void setMaxDelay(const double _maxDelay) { m_maxResources[0] = _maxDelay; }
+
+    void setMaxResources(const Resources& _maxResources) {
+        m_maxResources = _maxResources;
+    }
+
+    /**
+     * Search the constrained shortest path, computing the bounds to the
+     * target first. Returns false if there is no feasible path.
+     */
+    bool solve() {
+        m_bounds.computeToTarget(*m_network, m_target);
+        return solve(m_bounds);
+    }
+
+    /**
+     * Search the constrained shortest path with bounds to the target that
+     * were computed beforehand, for the current costs and resources
+     */
+    bool solve(const Bounds& _bounds);
+
+    /**
+     * Returns the path found by the last successful call to solve
+     */
+    [[nodiscard]] const Path& getPath() const { return m_path; }
+
+    /**
+     * Number of labels created by the last search
+     */
+    [[nodiscard]] std::size_t getNbLabels() const { return m_labels.size(); }
+
+    /**
+     * Number of labels discarded by dominance during the last search
+     */
+    [[nodiscard]] std::size_t getNbDominatedLabels() const {
+        return m_labels.getNbDominated();
+    }
+
+  private:
+    using Label = typename LabelPool<NbResources>::Label;
+
+    static constexpr std::size_t NONE = LabelPool<NbResources>::NONE;
+
+    void buildPath(std::size_t _label);
+
+    Network const* m_network;
+    std::size_t m_source{0};
+    std::size_t m_target{0};
+    Resources m_maxResources{};
+    Bounds m_bounds{};
+    LabelPool<NbResources> m_labels{};
+    // Min heap of (cost + cost bound, label)
+    std::vector<std::pair<double, std::size_t>> m_heap{};
+    Path m_path{};
+};
+
+template <std::size_t NbResources>
+bool LabelingConstrainedShortestPath<NbResources>::solve(
+    const Bounds& _bounds) {
+    assert(_bounds.getRoot() == m_target);
+    m_labels.reset(m_network->getNbNodes());
+    m_heap.clear();
+    m_path.clear();
+
+    const Resources noResources{};
+    if (_bounds.getCost(m_source) == Bounds::INFINITE_BOUND
+        || _bounds.exceeds(m_source, noResources, m_maxResources)) {
+        return false;
+    }
+    // Cost of the best label of the target created so far
+    double incumbent = std::numeric_limits<double>::infinity();
+    m_labels.add({0.0, noResources, m_source, NONE, NONE, false});
+    m_heap.emplace_back(_bounds.getCost(m_source), 0);
+    while (!m_heap.empty()) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+        const std::size_t id = m_heap.back().second;
+        m_heap.pop_back();
+        if (m_labels[id].dominated) {
+            continue;
+        }
+        const Label label = m_labels[id];
+        if (label.node == m_target) {
+            buildPath(id);
+            return true;
+        }
+        for (const auto& arc : m_network->getOutArcs(label.node)) {
+            Label next{label.cost + m_network->getCost(arc.edge),
+                label.resources, arc.node, id, arc.edge, false};
+            for (std::size_t r = 0; r < NbResources; ++r) {
+                next.resources[r] += m_network->getResources(arc.edge)[r];
+            }
+            const double bound = next.cost + _bounds.getCost(arc.node);
+            if (bound >= incumbent
+                || _bounds.exceeds(arc.node, next.resources, m_maxResources)
+                || !m_labels.add(next)) {
+                continue;
+            }
+            if (arc.node == m_target) {
+                incumbent = next.cost;
+            }
+            m_heap.emplace_back(bound, m_labels.size() - 1);
+            std::push_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+        }
+    }
+    return false;
+}
+
+template <std::size_t NbResources>
+void LabelingConstrainedShortestPath<NbResources>::buildPath(
+    const std::size_t _label) {
+    const auto& last = m_labels[_label];
+    m_path.cost = last.cost;
+    m_path.resources = last.resources;
+    for (auto id = _label; id != NONE; id = m_labels[id].pred) {
+        m_path.nodes.push_back(m_labels[id].node);
+        if (m_labels[id].edge != NONE) {
+            m_path.edges.push_back(m_labels[id].edge);
+        }
+    }
+    std::reverse(m_path.nodes.begin(), m_path.nodes.end());
+    std::reverse(m_path.edges.begin(), m_path.edges.end());
+}
+
+/**
+ * Exact resource constrained shortest path by bidirectional labeling.
+ *
+ * Forward labels from the source and backward labels from the target are
+ * only extended while they use at most half of the delay budget, which keeps
+ * both searches shallow on long paths. Every feasible path has an edge
+ * (u, v) such that its prefix to u uses at most half of the budget and its
+ * suffix from v uses less than half, so the join phase combines the
+ * extended forward labels of u with the backward labels of v along every
+ * edge.
+ *
+ * \tparam NbResources Number of resources constrained along the path, the
+ * first one being the delay, which is split between the directions
+ **/
+template <std::size_t NbResources = 1>
+class BidirectionalLabelingConstrainedShortestPath {
+  public:
+    using Network = ConstrainedShortestPathNetwork<NbResources>;
+    using Bounds = ConstrainedShortestPathBounds<NbResources>;
+    using Resources = typename Network::Resources;
+    using Path = ConstrainedPath<NbResources>;
+
+    /**
+     * Label counts of the last search, for tuning
+     */
+    struct Statistics {
+        std::size_t forwardLabels{0};
+        std::size_t backwardLabels{0};
+        // Labels discarded by dominance, in both directions
+        std::size_t dominated{0};
+        // Pairs of forward and backward labels evaluated by the join phase
+        std::size_t joined{0};
+    };
+
+    explicit BidirectionalLabelingConstrainedShortestPath(
+        const Network& _network)
+        : m_network(&_network) {
+        m_maxResources.fill(std::numeric_limits<double>::infinity());
+    }
+
+    /**
+     * Set the source and destination of the constrained shortest path
+     */
+    void setNodePair(const std::size_t _source, const std::size_t _target) {
+        m_source = _source;
+        m_target = _target;
+    }
+
+    void setMaxDelay(const double _maxDelay) { m_maxResources[0] = _maxDelay; }
+
+    void setMaxResources(const Resources& _maxResources) {
+        m_maxResources = _maxResources;
+    }
+
+    /**
+     * Search the constrained shortest path. Returns false if there is no
+     * feasible path.
+     */
+    bool solve();
+
+    /**
+     * Returns the path found by the last successful call to solve
+     */
+    [[nodiscard]] const Path& getPath() const { return m_path; }
+
+    [[nodiscard]] const Statistics& getStatistics() const {
+        return m_statistics;
+    }
+
+  private:
+    using Label = typename LabelPool<NbResources>::Label;
+    using Arcs = std::span<const typename Network::Arc> (Network::*)(
+        std::size_t) const;
+
+    static constexpr std::size_t NONE = LabelPool<NbResources>::NONE;
+
+    /**
+     * Labeling from _root along _arcs, by increasing delay. _bounds are the
+     * bounds of the other end, used to discard infeasible labels.
+     */
+    void extend(std::size_t _root, Arcs _arcs, const Bounds& _bounds,
+        LabelPool<NbResources>& _labels);
+
+    bool isExtended(const Label& _label) const {
+        return _label.resources[0] <= m_maxResources[0] / 2;
+    }
+
+    void buildPath(std::size_t _forward, std::size_t _edge,
+        std::size_t _backward, double _cost, const Resources& _resources);
+
+    Network const* m_network;
+    std::size_t m_source{0};
+    std::size_t m_target{0};
+    Resources m_maxResources{};
+    Bounds m_sourceBounds{};
+    Bounds m_targetBounds{};
+    LabelPool<NbResources> m_forwardLabels{};
+    LabelPool<NbResources> m_backwardLabels{};
+    // Min heap of (delay, label)
+    std::vector<std::pair<double, std::size_t>> m_heap{};
+    Statistics m_statistics{};
+    Path m_path{};
+};
+
+template <std::size_t NbResources>
+bool BidirectionalLabelingConstrainedShortestPath<NbResources>::solve() {
+    m_statistics = Statistics{};
+    m_path.clear();
+    m_sourceBounds.computeFromSource(*m_network, m_source);
+    m_targetBounds.computeToTarget(*m_network, m_target);
+    const Resources noResources{};
+    if (m_targetBounds.getCost(m_source) == Bounds::INFINITE_BOUND
+        || m_targetBounds.exceeds(m_source, noResources, m_maxResources)) {
+        return false;
+    }
+    if (m_source == m_target) {
+        m_path.nodes.push_back(m_source);
+        return true;
+    }
+
+    extend(m_source, &Network::getOutArcs, m_targetBounds, m_forwardLabels);
+    extend(m_target, &Network::getInArcs, m_sourceBounds, m_backwardLabels);
+    m_statistics.forwardLabels = m_forwardLabels.size();
+    m_statistics.backwardLabels = m_backwardLabels.size();
+    m_statistics.dominated =
+        m_forwardLabels.getNbDominated() + m_backwardLabels.getNbDominated();
+
+    double bestCost = std::numeric_limits<double>::infinity();
+    Resources bestResources{};
+    std::size_t bestForward = NONE;
+    std::size_t bestEdge = NONE;
+    std::size_t bestBackward = NONE;
+    for (std::size_t edge = 0; edge < m_network->getNbEdges(); ++edge) {
+        const auto& forwardLabels =
+            m_forwardLabels.getNodeLabels(m_network->getTail(edge));
+        const auto& backwardLabels =
+            m_backwardLabels.getNodeLabels(m_network->getHead(edge));
+        for (const auto forward : forwardLabels) {
+            const auto& forwardLabel = m_forwardLabels[forward];
+            if (!isExtended(forwardLabel)) {
+                continue;
+            }
+            const double forwardCost =
+                forwardLabel.cost + m_network->getCost(edge);
+            for (const auto backward : backwardLabels) {
+                const auto& backwardLabel = m_backwardLabels[backward];
+                ++m_statistics.joined;
+                const double cost = forwardCost + backwardLabel.cost;
+                if (cost >= bestCost) {
+                    continue;
+                }
+                Resources resources = forwardLabel.resources;
+                bool isFeasible = true;
+                for (std::size_t r = 0; r < NbResources && isFeasible; ++r) {
+                    resources[r] += m_network->getResources(edge)[r]
+                                    + backwardLabel.resources[r];
+                    isFeasible = resources[r] <= m_maxResources[r];
+                }
+                if (isFeasible) {
+                    bestCost = cost;
+                    bestResources = resources;
+                    bestForward = forward;
+                    bestEdge = edge;
+                    bestBackward = backward;
+                }
+            }
+        }
+    }
+    if (bestEdge == NONE) {
+        return false;
+    }
+    buildPath(bestForward, bestEdge, bestBackward, bestCost, bestResources);
+    return true;
+}
+
+template <std::size_t NbResources>
+void BidirectionalLabelingConstrainedShortestPath<NbResources>::extend(
+    const std::size_t _root, const Arcs _arcs, const Bounds& _bounds,
+    LabelPool<NbResources>& _labels) {
+    _labels.reset(m_network->getNbNodes());
+    m_heap.clear();
+    _labels.add({0.0, Resources{}, _root, NONE, NONE, false});
+    m_heap.emplace_back(0.0, 0);
+    while (!m_heap.empty()) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+        const std::size_t id = m_heap.back().second;
+        m_heap.pop_back();
+        if (_labels[id].dominated) {
+            continue;
+        }
+        const Label label = _labels[id];
+        for (const auto& arc : (m_network->*_arcs)(label.node)) {
+            Label next{label.cost + m_network->getCost(arc.edge),
+                label.resources, arc.node, id, arc.edge, false};
+            for (std::size_t r = 0; r < NbResources; ++r) {
+                next.resources[r] += m_network->getResources(arc.edge)[r];
+            }
+            if (_bounds.exceeds(arc.node, next.resources, m_maxResources)
+                || !_labels.add(next)) {
+                continue;
+            }
+            // Labels past half of the budget are only used by the join
+            if (isExtended(next)) {
+                m_heap.emplace_back(next.resources[0], _labels.size() - 1);
+                std::push_heap(
+                    m_heap.begin(), m_heap.end(), std::greater<>());
+            }
+        }
+    }
+}
+
+template <std::size_t NbResources>
+void BidirectionalLabelingConstrainedShortestPath<NbResources>::buildPath(
+    const std::size_t _forward, const std::size_t _edge,
+    const std::size_t _backward, const double _cost,
+    const Resources& _resources) {
+    m_path.cost = _cost;
+    m_path.resources = _resources;
+    for (auto id = _forward; id != NONE; id = m_forwardLabels[id].pred) {
+        m_path.nodes.push_back(m_forwardLabels[id].node);
+        if (m_forwardLabels[id].edge != NONE) {
+            m_path.edges.push_back(m_forwardLabels[id].edge);
+        }
+    }
+    std::reverse(m_path.nodes.begin(), m_path.nodes.end());
+    std::reverse(m_path.edges.begin(), m_path.edges.end());
+    m_path.edges.push_back(_edge);
+    // Backward labels lead to the target through their predecessors
+    for (auto id = _backward; id != NONE; id = m_backwardLabels[id].pred) {
+        m_path.nodes.push_back(m_backwardLabels[id].node);
+        if (m_backwardLabels[id].edge != NONE) {
+            m_path.edges.push_back(m_backwardLabels[id].edge);
+        }
+    }
+}
+
+} // namespace CppRO
+#endif
@@ -0,0 +1,307 @@
+#ifndef CPPRO_CONSTRAINEDSHORTESTPATHNETWORK
+#define CPPRO_CONSTRAINEDSHORTESTPATHNETWORK
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/range/iterator_range.hpp>
+
+namespace CppRO {
+
+/**
+ * Graph of a resource constrained shortest path problem, stored as forward
+ * and backward adjacency arrays.
+ *
+ * Edges keep the indices given by the edge index map of the original graph,
+ * so the costs and resources are given by ranges indexed like the flow
+ * variables of CompactConstrainedShortestPathModel. The first resource is the
+ * delay. Costs and resources must be non negative.
+ *
+ * \tparam NbResources Number of resources constrained along the path
+ **/
+template <std::size_t NbResources = 1>
+class ConstrainedShortestPathNetwork {
+  public:
+    using Resources = std::array<double, NbResources>;
+
+    /**
+     * Edge seen from one of its end nodes: the other end node and the index
+     * of the edge
+     */
+    struct Arc {
+        std::size_t node;
+        std::size_t edge;
+    };
+
+    /**
+     * Build the network according to the graph and its edge indices. Costs
+     * and resources are 0 until set.
+     *
+     * \tparam Graph A class representing a graph
+     * \tparam EdgeIndexPropertyMap A class representing a property map of
+     * edge indices
+     **/
+    template <typename Graph, typename EdgeIndexPropertyMap>
+    ConstrainedShortestPathNetwork(
+        const Graph& _graph, const EdgeIndexPropertyMap& _edgeIndices);
+
+    [[nodiscard]] std::size_t getNbNodes() const {
+        return m_outOffsets.size() - 1;
+    }
+
+    [[nodiscard]] std::size_t getNbEdges() const { return m_costs.size(); }
+
+    [[nodiscard]] std::span<const Arc> getOutArcs(const std::size_t _u) const {
+        return {m_outArcs.data() + m_outOffsets[_u],
+            m_outArcs.data() + m_outOffsets[_u + 1]};
+    }
+
+    [[nodiscard]] std::span<const Arc> getInArcs(const std::size_t _v) const {
+        return {m_inArcs.data() + m_inOffsets[_v],
+            m_inArcs.data() + m_inOffsets[_v + 1]};
+    }
+
+    [[nodiscard]] std::size_t getTail(const std::size_t _edge) const {
+        return m_ends[_edge].first;
+    }
+
+    [[nodiscard]] std::size_t getHead(const std::size_t _edge) const {
+        return m_ends[_edge].second;
+    }
+
+    [[nodiscard]] double getCost(const std::size_t _edge) const {
+        return m_costs[_edge];
+    }
+
+    [[nodiscard]] const Resources& getResources(const std::size_t _edge) const {
+        return m_resources[_edge];
+    }
+
+    template <typename CostRange>
+    void setCosts(const CostRange& _costRange);
+
+    template <typename ResourceRange>
+    void setResources(std::size_t _resource, const ResourceRange& _range);
+
+    template <typename DelayRange>
+    void setDelays(const DelayRange& _delayRange) {
+        setResources(0, _delayRange);
+    }
+
+  private:
+    std::vector<std::pair<std::size_t, std::size_t>> m_ends;
+    std::vector<double> m_costs;
+    std::vector<Resources> m_resources;
+    std::vector<std::size_t> m_outOffsets;
+    std::vector<Arc> m_outArcs;
+    std::vector<std::size_t> m_inOffsets;
+    std::vector<Arc> m_inArcs;
+};
+
+template <std::size_t NbResources>
+template <typename Graph, typename EdgeIndexPropertyMap>
+ConstrainedShortestPathNetwork<NbResources>::ConstrainedShortestPathNetwork(
+    const Graph& _graph, const EdgeIndexPropertyMap& _edgeIndices)
+    : m_ends(num_edges(_graph))
+    , m_costs(num_edges(_graph), 0.0)
+    , m_resources(num_edges(_graph), Resources{})
+    , m_outOffsets(num_vertices(_graph) + 1, 0)
+    , m_outArcs(num_edges(_graph))
+    , m_inOffsets(num_vertices(_graph) + 1, 0)
+    , m_inArcs(num_edges(_graph)) {
+    for (const auto ed : boost::make_iterator_range(edges(_graph))) {
+        const std::size_t edge = get(_edgeIndices, ed);
+        m_ends[edge] = {source(ed, _graph), target(ed, _graph)};
+        ++m_outOffsets[m_ends[edge].first + 1];
+        ++m_inOffsets[m_ends[edge].second + 1];
+    }
+    for (std::size_t u = 0; u < getNbNodes(); ++u) {
+        m_outOffsets[u + 1] += m_outOffsets[u];
+        m_inOffsets[u + 1] += m_inOffsets[u];
+    }
+    std::vector<std::size_t> outPositions(
+        m_outOffsets.begin(), m_outOffsets.end() - 1);
+    std::vector<std::size_t> inPositions(
+        m_inOffsets.begin(), m_inOffsets.end() - 1);
+    for (std::size_t edge = 0; edge < getNbEdges(); ++edge) {
+        const auto [u, v] = m_ends[edge];
+        m_outArcs[outPositions[u]++] = {v, edge};
+        m_inArcs[inPositions[v]++] = {u, edge};
+    }
+}
+
+template <std::size_t NbResources>
+template <typename CostRange>
+void ConstrainedShortestPathNetwork<NbResources>::setCosts(
+    const CostRange& _costRange) {
+    std::size_t edge = 0;
+    for (const auto& cost : _costRange) {
+        assert(cost >= 0);
+        m_costs[edge++] = static_cast<double>(cost);
+    }
+    assert(edge == getNbEdges());
+}
+
+template <std::size_t NbResources>
+template <typename ResourceRange>
+void ConstrainedShortestPathNetwork<NbResources>::setResources(
+    const std::size_t _resource, const ResourceRange& _range) {
+    assert(_resource < NbResources);
+    std::size_t edge = 0;
+    for (const auto& consumption : _range) {
+        assert(consumption >= 0);
+        m_resources[edge++][_resource] = static_cast<double>(consumption);
+    }
+    assert(edge == getNbEdges());
+}
+
+/**
+ * Lower bounds on the cost and on each resource of the paths from every node
+ * to a target, or from a source to every node, computed by one Dijkstra per
+ * criterion. Unreachable nodes have infinite bounds, so the bounds can be
+ * added to partial path values without overflow checks.
+ **/
+template <std::size_t NbResources = 1>
+class ConstrainedShortestPathBounds {
+  public:
+    using Network = ConstrainedShortestPathNetwork<NbResources>;
+    using Resources = typename Network::Resources;
+
+    static constexpr double INFINITE_BOUND =
+        std::numeric_limits<double>::infinity();
+
+    /**
+     * Compute the bounds of the paths from every node to _target
+     */
+    void computeToTarget(const Network& _network, std::size_t _target) {
+        compute(_network, _target, &Network::getInArcs);
+    }
+
+    /**
+     * Compute the bounds of the paths from _source to every node
+     */
+    void computeFromSource(const Network& _network, std::size_t _source) {
+        compute(_network, _source, &Network::getOutArcs);
+    }
+
+    /**
+     * Node the bounds were computed from
+     */
+    [[nodiscard]] std::size_t getRoot() const { return m_root; }
+
+    [[nodiscard]] double getCost(const std::size_t _u) const {
+        return m_cost[_u];
+    }
+
+    [[nodiscard]] const Resources& getResources(const std::size_t _u) const {
+        return m_resources[_u];
+    }
+
+    /**
+     * Returns true if a path going through _u with the given partial values
+     * can not satisfy _maxResources
+     */
+    [[nodiscard]] bool exceeds(const std::size_t _u,
+        const Resources& _resources, const Resources& _maxResources) const {
+        for (std::size_t r = 0; r < NbResources; ++r) {
+            if (_resources[r] + m_resources[_u][r] > _maxResources[r]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+  private:
+    using Arcs = std::span<const typename Network::Arc> (Network::*)(
+        std::size_t) const;
+
+    void compute(const Network& _network, std::size_t _root, Arcs _arcs);
+
+    template <typename WeightFunction>
+    void dijkstra(const Network& _network, std::size_t _root, Arcs _arcs,
+        WeightFunction _weight, std::vector<double>& _distance);
+
+    std::size_t m_root{0};
+    std::vector<double> m_cost{};
+    std::vector<Resources> m_resources{};
+    std::vector<double> m_distance{};
+    std::vector<std::pair<double, std::size_t>> m_heap{};
+};
+
+template <std::size_t NbResources>
+void ConstrainedShortestPathBounds<NbResources>::compute(
+    const Network& _network, const std::size_t _root, const Arcs _arcs) {
+    m_root = _root;
+    dijkstra(
+        _network, _root, _arcs,
+        [&](const std::size_t _edge) { return _network.getCost(_edge); },
+        m_cost);
+    m_resources.resize(_network.getNbNodes());
+    for (std::size_t r = 0; r < NbResources; ++r) {
+        dijkstra(
+            _network, _root, _arcs,
+            [&](const std::size_t _edge) {
+                return _network.getResources(_edge)[r];
+            },
+            m_distance);
+        for (std::size_t u = 0; u < _network.getNbNodes(); ++u) {
+            m_resources[u][r] = m_distance[u];
+        }
+    }
+}
+
+template <std::size_t NbResources>
+template <typename WeightFunction>
+void ConstrainedShortestPathBounds<NbResources>::dijkstra(
+    const Network& _network, const std::size_t _root, const Arcs _arcs,
+    WeightFunction _weight, std::vector<double>& _distance) {
+    _distance.assign(_network.getNbNodes(), INFINITE_BOUND);
+    _distance[_root] = 0.0;
+    m_heap.assign(1, {0.0, _root});
+    while (!m_heap.empty()) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+        const auto [distance, u] = m_heap.back();
+        m_heap.pop_back();
+        if (distance != _distance[u]) {
+            continue;
+        }
+        for (const auto& arc : (_network.*_arcs)(u)) {
+            const double newDistance = distance + _weight(arc.edge);
+            if (newDistance < _distance[arc.node]) {
+                _distance[arc.node] = newDistance;
+                m_heap.emplace_back(newDistance, arc.node);
+                std::push_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+            }
+        }
+    }
+}
+
+/**
+ * Solution of a constrained shortest path query
+ **/
+template <std::size_t NbResources = 1>
+struct ConstrainedPath {
+    double cost{0.0};
+    std::array<double, NbResources> resources{};
+    // Nodes from the source to the target
+    std::vector<std::size_t> nodes{};
+    // Edge indices from the source to the target
+    std::vector<std::size_t> edges{};
+
+    void clear() {
+        cost = 0.0;
+        resources.fill(0.0);
+        nodes.clear();
+        edges.clear();
+    }
+};
+
+} // namespace CppRO
+#endif
@@ -0,0 +1,302 @@
+#ifndef CPPRO_CONSTRAINEDSHORTESTPATHPULSE
+#define CPPRO_CONSTRAINEDSHORTESTPATHPULSE
+
+#include <CppRO/ConstrainedShortestPathLabeling.hpp>
+#include <CppRO/ConstrainedShortestPathNetwork.hpp>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <limits>
+#include <vector>
+
+#include <omp.h>
+
+namespace CppRO {
+
+/**
+ * Exact resource constrained shortest path with the Pulse algorithm of
+ * Lozano and Medaglia.
+ *
+ * Pulses go depth first from the source and are stopped when they close a
+ * cycle, when the resource bounds to the target make them infeasible, when the
+ * cost bound to the target reaches the best path found so far, or when a
+ * pulse that went through the same node earlier dominates them. Each node
+ * remembers the pulse of least cost and, for each resource, the pulse using
+ * the least of it.
+ *
+ * The pulses leaving the source are spread over the threads. The threads
+ * share the cost of the best path, so a path found by one thread prunes the
+ * others, and keep their own dominance memory.
+ *
+ * \tparam NbResources Number of resources constrained along the path, the
+ * first one being the delay
+ **/
+template <std::size_t NbResources = 1>
+class PulseConstrainedShortestPath {
+  public:
+    using Network = ConstrainedShortestPathNetwork<NbResources>;
+    using Bounds = ConstrainedShortestPathBounds<NbResources>;
+    using Resources = typename Network::Resources;
+    using Path = ConstrainedPath<NbResources>;
+
+    explicit PulseConstrainedShortestPath(const Network& _network)
+        : m_network(&_network) {
+        m_maxResources.fill(std::numeric_limits<double>::infinity());
+    }
+
+    /**
+     * Set the source and destination of the constrained shortest path
+     */
+    void setNodePair(const std::size_t _source, const std::size_t _target) {
+        m_source = _source;
+        m_target = _target;
+    }
+
+    void setMaxDelay(const double _maxDelay) { m_maxResources[0] = _maxDelay; }
+
+    void setMaxResources(const Resources& _maxResources) {
+        m_maxResources = _maxResources;
+    }
+
+    /**
+     * Search the constrained shortest path, computing the bounds to the
+     * target first. Returns false if there is no feasible path.
+     */
+    bool solve(const int _nbThreads = omp_get_max_threads()) {
+        m_bounds.computeToTarget(*m_network, m_target);
+        return solve(m_bounds, _nbThreads);
+    }
+
+    /**
+     * Search the constrained shortest path with bounds to the target that
+     * were computed beforehand, for the current costs and resources
+     */
+    bool solve(const Bounds& _bounds, int _nbThreads = omp_get_max_threads());
+
+    /**
+     * Returns the path found by the last successful call to solve
+     */
+    [[nodiscard]] const Path& getPath() const { return m_path; }
+
+    /**
+     * Number of pulses that were propagated by the last search
+     */
+    [[nodiscard]] std::size_t getNbPulses() const { return m_nbPulses; }
+
+  private:
+    static constexpr std::size_t NONE = LabelPool<NbResources>::NONE;
+
+    /**
+     * Pulse on the stack of the depth first search
+     */
+    struct Pulse {
+        std::size_t node;
+        // Edge the pulse came from
+        std::size_t edge;
+        // Position of the next out arc of node to follow
+        std::size_t nextArc;
+        double cost;
+        Resources resources;
+    };
+
+    /**
+     * Cost and resources of a pulse remembered for the dominance pruning
+     */
+    struct Memory {
+        double cost;
+        Resources resources;
+    };
+
+    /**
+     * State of a thread: the current path and the remembered pulses
+     */
+    struct Workspace {
+        std::vector<Pulse> stack{};
+        std::vector<char> onPath{};
+        std::vector<std::array<Memory, NbResources + 1>> memories{};
+
+        void reset(std::size_t _nbNodes);
+
+        bool isDominated(std::size_t _u, double _cost,
+            const Resources& _resources) const;
+
+        void remember(
+            std::size_t _u, double _cost, const Resources& _resources);
+    };
+
+    /**
+     * Propagate the pulse sent from the source along _arc and every pulse it
+     * leads to. Returns the number of pulses.
+     */
+    std::size_t propagate(const typename Network::Arc& _arc,
+        const Bounds& _bounds, Workspace& _workspace);
+
+    /**
+     * Replace the best path by the one on the stack of _workspace followed
+     * by _arc if it is still cheaper
+     */
+    void updateBestPath(const Workspace& _workspace,
+        const typename Network::Arc& _arc, double _cost,
+        const Resources& _resources);
+
+    Network const* m_network;
+    std::size_t m_source{0};
+    std::size_t m_target{0};
+    Resources m_maxResources{};
+    Bounds m_bounds{};
+    std::vector<Workspace> m_workspaces{};
+    std::atomic<double> m_bestCost{0.0};
+    std::size_t m_nbPulses{0};
+    Path m_path{};
+};
+
+template <std::size_t NbResources>
+bool PulseConstrainedShortestPath<NbResources>::solve(
+    const Bounds& _bounds, const int _nbThreads) {
+    assert(_bounds.getRoot() == m_target);
+    m_path.clear();
+    m_nbPulses = 0;
+    m_bestCost.store(std::numeric_limits<double>::infinity());
+
+    const Resources noResources{};
+    if (_bounds.getCost(m_source) == Bounds::INFINITE_BOUND
+        || _bounds.exceeds(m_source, noResources, m_maxResources)) {
+        return false;
+    }
+    if (m_source == m_target) {
+        m_path.nodes.push_back(m_source);
+        return true;
+    }
+
+    const auto firstArcs = m_network->getOutArcs(m_source);
+    m_workspaces.resize(static_cast<std::size_t>(_nbThreads));
+    std::size_t nbPulses = 0;
+#pragma omp parallel num_threads(_nbThreads) reduction(+ : nbPulses)
+    {
+        auto& workspace =
+            m_workspaces[static_cast<std::size_t>(omp_get_thread_num())];
+        workspace.reset(m_network->getNbNodes());
+#pragma omp for schedule(dynamic)
+        for (std::size_t i = 0; i < firstArcs.size(); ++i) {
+            nbPulses += propagate(firstArcs[i], _bounds, workspace);
+        }
+    }
+    m_nbPulses = nbPulses;
+    return !m_path.nodes.empty();
+}
+
+template <std::size_t NbResources>
+std::size_t PulseConstrainedShortestPath<NbResources>::propagate(
+    const typename Network::Arc& _arc, const Bounds& _bounds,
+    Workspace& _workspace) {
+    auto& stack = _workspace.stack;
+    auto& onPath = _workspace.onPath;
+    std::size_t nbPulses = 0;
+    // Send a pulse along _nextArc from the pulse on top of the stack
+    const auto send = [&](const typename Network::Arc& _nextArc) {
+        const std::size_t v = _nextArc.node;
+        if (onPath[v]) {
+            return;
+        }
+        const auto& pulse = stack.back();
+        const double cost = pulse.cost + m_network->getCost(_nextArc.edge);
+        Resources resources = pulse.resources;
+        for (std::size_t r = 0; r < NbResources; ++r) {
+            resources[r] += m_network->getResources(_nextArc.edge)[r];
+        }
+        if (_bounds.exceeds(v, resources, m_maxResources)
+            || cost + _bounds.getCost(v) >= m_bestCost.load()
+            || _workspace.isDominated(v, cost, resources)) {
+            return;
+        }
+        ++nbPulses;
+        if (v == m_target) {
+            updateBestPath(_workspace, _nextArc, cost, resources);
+            return;
+        }
+        _workspace.remember(v, cost, resources);
+        stack.push_back({v, _nextArc.edge, 0, cost, resources});
+        onPath[v] = 1;
+    };
+
+    // The source stays at the bottom of the stack and only sends _arc
+    stack.push_back({m_source, NONE, 0, 0.0, Resources{}});
+    onPath[m_source] = 1;
+    send(_arc);
+    while (stack.size() > 1) {
+        auto& pulse = stack.back();
+        const auto arcs = m_network->getOutArcs(pulse.node);
+        if (pulse.nextArc == arcs.size()) {
+            onPath[pulse.node] = 0;
+            stack.pop_back();
+            continue;
+        }
+        send(arcs[pulse.nextArc++]);
+    }
+    onPath[m_source] = 0;
+    stack.clear();
+    return nbPulses;
+}
+
+template <std::size_t NbResources>
+void PulseConstrainedShortestPath<NbResources>::updateBestPath(
+    const Workspace& _workspace, const typename Network::Arc& _arc,
+    const double _cost, const Resources& _resources) {
+#pragma omp critical(PulseConstrainedShortestPath_bestPath)
+    if (_cost < m_bestCost.load()) {
+        m_bestCost.store(_cost);
+        m_path.clear();
+        m_path.cost = _cost;
+        m_path.resources = _resources;
+        for (const auto& pulse : _workspace.stack) {
+            m_path.nodes.push_back(pulse.node);
+            if (pulse.edge != NONE) {
+                m_path.edges.push_back(pulse.edge);
+            }
+        }
+        m_path.nodes.push_back(_arc.node);
+        m_path.edges.push_back(_arc.edge);
+    }
+}
+
+template <std::size_t NbResources>
+void PulseConstrainedShortestPath<NbResources>::Workspace::reset(
+    const std::size_t _nbNodes) {
+    Memory none{std::numeric_limits<double>::infinity(), {}};
+    none.resources.fill(std::numeric_limits<double>::infinity());
+    stack.clear();
+    onPath.assign(_nbNodes, 0);
+    memories.resize(_nbNodes);
+    for (auto& memory : memories) {
+        memory.fill(none);
+    }
+}
+
+template <std::size_t NbResources>
+bool PulseConstrainedShortestPath<NbResources>::Workspace::isDominated(
+    const std::size_t _u, const double _cost,
+    const Resources& _resources) const {
+    for (const auto& memory : memories[_u]) {
+        if (dominates(memory.cost, memory.resources, _cost, _resources)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <std::size_t NbResources>
+void PulseConstrainedShortestPath<NbResources>::Workspace::remember(
+    const std::size_t _u, const double _cost, const Resources& _resources) {
+    auto& memory = memories[_u];
+    if (_cost < memory[0].cost) {
+        memory[0] = {_cost, _resources};
+    }
+    for (std::size_t r = 0; r < NbResources; ++r) {
+        if (_resources[r] < memory[r + 1].resources[r]) {
+            memory[r + 1] = {_cost, _resources};
+        }
+    }
+}
+
+} // namespace CppRO
+#endif
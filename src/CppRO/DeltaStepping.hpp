@@ -0,0 +1,267 @@
+#ifndef DELTASTEPPING_HPP
+#define DELTASTEPPING_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <omp.h>
+
+#include "Graph.hpp"
+
+/**
+ * Parallel single source shortest path tree using delta-stepping (Meyer and
+ * Sanders). Nodes are kept in buckets of width delta. The edges of weight at
+ * most delta (light edges) of a bucket are relaxed repeatedly until the bucket
+ * is empty, then its heavy edges are relaxed once.
+ *
+ * Each node is owned by one thread (node % number of threads): only the owner
+ * updates the distance, parent and bucket of a node. The other threads send
+ * it relaxation requests through per thread buffers, so no atomics are needed.
+ * Ties are broken towards the smallest parent, so the parent array does not
+ * depend on the number of threads.
+ *
+ * Edge weights must be non negative.
+ */
+template <typename G>
+class DeltaStepping {
+  public:
+    using weight_type = typename G::weight_type;
+
+    DeltaStepping(const G& _graph, const weight_type _delta,
+        const int _nbThreads = omp_get_max_threads())
+        : m_graph(&_graph)
+        , m_delta(_delta)
+        , m_nbThreads(_nbThreads)
+        , m_distance(_graph.getOrder(), std::numeric_limits<weight_type>::max())
+        , m_parent(_graph.getOrder(), -1)
+        , m_bucketOf(_graph.getOrder(), -1)
+        , m_lightEdges(_graph.getOrder())
+        , m_heavyEdges(_graph.getOrder()) {
+        assert(_delta > 0);
+    }
+
+    DeltaStepping(const DeltaStepping&) = default;
+    DeltaStepping& operator=(const DeltaStepping&) = default;
+    DeltaStepping(DeltaStepping&&) noexcept = default;
+    DeltaStepping& operator=(DeltaStepping&&) noexcept = default;
+    ~DeltaStepping() = default;
+
+    void setDelta(const weight_type _delta) {
+        assert(_delta > 0);
+        m_delta = _delta;
+    }
+
+    weight_type getDelta() const { return m_delta; }
+
+    weight_type getDistance(const Graph::Node _u) const {
+        return m_distance[_u];
+    }
+
+    Graph::Node getParent(const Graph::Node _u) const { return m_parent[_u]; }
+
+    const std::vector<weight_type>& getDistances() const { return m_distance; }
+
+    const std::vector<Graph::Node>& getParents() const { return m_parent; }
+
+    void computeShortestPathTree(Graph::Node _s);
+
+    Graph::Path getShortestPath(const Graph::Node _s, const Graph::Node _t) {
+        computeShortestPathTree(_s);
+        Graph::Path path;
+        if (m_parent[_t] != -1) {
+            Graph::Node node = _t;
+            while (node != _s) {
+                path.push_back(node);
+                node = m_parent[node];
+            }
+            path.push_back(node);
+            std::reverse(path.begin(), path.end());
+        }
+        return path;
+    }
+
+  private:
+    struct Request {
+        Graph::Node node;
+        Graph::Node parent;
+        weight_type distance;
+    };
+
+    long getBucketIndex(const weight_type _distance) const {
+        return static_cast<long>(_distance / m_delta);
+    }
+
+    /**
+     * Apply the requests sent to the thread _owner. Improved nodes are moved
+     * to the bucket of their new distance.
+     */
+    void applyRequests(const int _owner) {
+        const auto nbBuckets = static_cast<long>(m_buckets[_owner].size());
+        for (auto& requests : m_requests) {
+            for (const auto& [v, u, dist] : requests[_owner]) {
+                if (dist < m_distance[v]) {
+                    m_distance[v] = dist;
+                    m_parent[v] = u;
+                    const auto bucket = getBucketIndex(dist);
+                    if (m_bucketOf[v] != bucket) {
+                        m_bucketOf[v] = bucket;
+                        m_buckets[_owner][bucket % nbBuckets].push_back(v);
+                    }
+                } else if (dist == m_distance[v] && u < m_parent[v]
+                           && m_parent[v] != v) {
+                    m_parent[v] = u;
+                }
+            }
+            requests[_owner].clear();
+        }
+    }
+
+    template <typename EdgeList>
+    void sendRequests(
+        const int _thread, const Graph::Node _u, const EdgeList& _edges) {
+        const auto nbThreads = static_cast<int>(m_requests.size());
+        for (const auto& [v, weight] : _edges) {
+            m_requests[_thread][v % nbThreads].push_back(
+                {v, _u, m_distance[_u] + weight});
+        }
+    }
+
+    G const* m_graph;
+    weight_type m_delta;
+    int m_nbThreads;
+    std::vector<weight_type> m_distance;
+    std::vector<Graph::Node> m_parent;
+    std::vector<long> m_bucketOf;
+    std::vector<std::vector<std::pair<Graph::Node, weight_type>>> m_lightEdges;
+    std::vector<std::vector<std::pair<Graph::Node, weight_type>>> m_heavyEdges;
+    // m_buckets[thread][index % nbBuckets]
+    std::vector<std::vector<std::vector<Graph::Node>>> m_buckets{};
+    // m_requests[sender][owner]
+    std::vector<std::vector<std::vector<Request>>> m_requests{};
+};
+
+template <typename G>
+void DeltaStepping<G>::computeShortestPathTree(const Graph::Node _s) {
+    const int order = m_graph->getOrder();
+    std::vector<weight_type> maxWeights;
+    std::vector<char> nonEmptyBucket;
+    std::vector<std::vector<Graph::Node>> settled;
+    long currentBucket = 0;
+
+#pragma omp parallel num_threads(m_nbThreads)
+    {
+        const int nbThreads = omp_get_num_threads();
+        const int thread = omp_get_thread_num();
+#pragma omp single
+        {
+            maxWeights.assign(nbThreads, weight_type(0));
+            nonEmptyBucket.assign(nbThreads, 0);
+            settled.resize(nbThreads);
+            m_requests.resize(nbThreads);
+            for (auto& requests : m_requests) {
+                requests.resize(nbThreads);
+            }
+            m_buckets.resize(nbThreads);
+        }
+
+        // Reset the owned nodes and split their edges
+        for (Graph::Node u = thread; u < order; u += nbThreads) {
+            m_distance[u] = std::numeric_limits<weight_type>::max();
+            m_parent[u] = -1;
+            m_bucketOf[u] = -1;
+            m_lightEdges[u].clear();
+            m_heavyEdges[u].clear();
+            for (const auto v : m_graph->getNeighbors(u)) {
+                const auto weight = m_graph->getEdgeWeight(u, v);
+                assert(weight >= 0);
+                maxWeights[thread] = std::max(maxWeights[thread], weight);
+                if (weight <= m_delta) {
+                    m_lightEdges[u].emplace_back(v, weight);
+                } else {
+                    m_heavyEdges[u].emplace_back(v, weight);
+                }
+            }
+        }
+#pragma omp barrier
+#pragma omp single
+        {
+            // A relaxation never goes further than the largest weight, so the
+            // buckets can be reused cyclically.
+            const auto maxWeight =
+                *std::max_element(maxWeights.begin(), maxWeights.end());
+            const auto nbBuckets = getBucketIndex(maxWeight) + 2;
+            for (auto& buckets : m_buckets) {
+                buckets.resize(nbBuckets);
+                for (auto& bucket : buckets) {
+                    bucket.clear();
+                }
+            }
+            m_distance[_s] = 0;
+            m_parent[_s] = _s;
+            m_bucketOf[_s] = 0;
+            m_buckets[_s % nbThreads][0].push_back(_s);
+        }
+
+        auto& buckets = m_buckets[thread];
+        const auto nbBuckets = static_cast<long>(buckets.size());
+        std::vector<Graph::Node> frontier;
+        while (currentBucket != -1) {
+            const long bucketIndex = currentBucket;
+            auto& bucket = buckets[bucketIndex % nbBuckets];
+            // Light edges until the bucket stays empty
+            while (true) {
+                frontier.swap(bucket);
+                for (const auto u : frontier) {
+                    if (m_bucketOf[u] == bucketIndex) {
+                        m_bucketOf[u] = -1;
+                        settled[thread].push_back(u);
+                        sendRequests(thread, u, m_lightEdges[u]);
+                    }
+                }
+                frontier.clear();
+#pragma omp barrier
+                applyRequests(thread);
+                nonEmptyBucket[thread] = !bucket.empty();
+#pragma omp barrier
+                const bool anyNonEmpty = std::any_of(nonEmptyBucket.begin(),
+                    nonEmptyBucket.end(), [](const char _b) { return _b; });
+#pragma omp barrier
+                if (!anyNonEmpty) {
+                    break;
+                }
+            }
+
+            // Heavy edges of the nodes removed from the bucket
+            std::sort(settled[thread].begin(), settled[thread].end());
+            settled[thread].erase(
+                std::unique(settled[thread].begin(), settled[thread].end()),
+                settled[thread].end());
+            for (const auto u : settled[thread]) {
+                sendRequests(thread, u, m_heavyEdges[u]);
+            }
+            settled[thread].clear();
+#pragma omp barrier
+            applyRequests(thread);
+#pragma omp barrier
+#pragma omp single
+            {
+                currentBucket = -1;
+                for (long i = bucketIndex + 1; i < bucketIndex + nbBuckets;
+                     ++i) {
+                    if (std::any_of(m_buckets.begin(), m_buckets.end(),
+                            [&](const auto& _buckets) {
+                                return !_buckets[i % nbBuckets].empty();
+                            })) {
+                        currentBucket = i;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif
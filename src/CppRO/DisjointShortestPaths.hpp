@@ -0,0 +1,386 @@
+#ifndef DISJOINTSHORTESTPATHS_HPP
+#define DISJOINTSHORTESTPATHS_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <omp.h>
+
+#include "Graph.hpp"
+#include "PathArena.hpp"
+#include "SearchWorkspace.hpp"
+
+/**
+ * K edge or node disjoint paths of minimum total weight between two nodes,
+ * with the algorithm of Suurballe generalized to k paths.
+ *
+ * Each path is a unit flow augmentation along a shortest path of the residual
+ * network. The searches are Dijkstra on the weights reduced by node
+ * potentials, which keep them non negative once the residual network has
+ * arcs of negative weight, so k paths cost k searches in O(m log n). A search
+ * stops once the target is settled: the potential of the settled nodes grows
+ * by their distance and the others by the distance of the target, which is
+ * also valid and only touches the settled nodes.
+ *
+ * Node disjoint paths are edge disjoint paths of the graph in which each node
+ * u is split into u_in -> u_out, with the arcs entering u going to u_in and
+ * the arcs leaving u starting from u_out.
+ *
+ * The residual network is built once from the graph and shared by the copies
+ * of a solver, so each thread of a batch only owns its flow and search state.
+ * Edge weights must be non negative.
+ */
+template <typename G>
+class DisjointShortestPaths {
+  public:
+    using weight_type = typename G::weight_type;
+
+    enum class Disjointness { Edge, Node };
+
+    /**
+     * Pair of nodes to connect with disjoint paths
+     */
+    struct Demand {
+        Graph::Node source;
+        Graph::Node target;
+    };
+
+    explicit DisjointShortestPaths(
+        const G& _graph, Disjointness _disjointness = Disjointness::Edge);
+
+    /**
+     * \brief Search _k disjoint paths from _s to _t of minimum total weight
+     * Returns the number of paths found, less than _k if the graph does not
+     * have _k disjoint paths between _s and _t. The paths are then available
+     * with getPaths, by increasing weight.
+     */
+    int computeDisjointPaths(Graph::Node _s, Graph::Node _t, int _k = 2);
+
+    /**
+     * \brief Search _k disjoint paths for every demand, spread over
+     * _nbThreads threads
+     * The paths of the i-th demand are written into _paths[i] by increasing
+     * weight, and their total weight into _weights[i].
+     */
+    void computeDisjointPaths(const std::vector<Demand>& _demands, int _k,
+        std::vector<PathArena>& _paths, std::vector<weight_type>& _weights,
+        int _nbThreads = omp_get_max_threads()) const;
+
+    /**
+     * \brief Paths found by the last search, by increasing weight
+     */
+    const PathArena& getPaths() const { return m_paths; }
+
+    /**
+     * \brief Weight of the i-th path found by the last search
+     */
+    weight_type getWeight(const std::size_t _i) const { return m_weights[_i]; }
+
+    /**
+     * \brief Total weight of the paths found by the last search
+     */
+    weight_type getTotalWeight() const {
+        return std::accumulate(
+            m_weights.begin(), m_weights.end(), weight_type(0));
+    }
+
+  private:
+    /**
+     * Residual network with unit capacities. Arcs 2e and 2e + 1 are the
+     * forward and backward arcs of the e-th edge, the edges of the graph
+     * coming before the split edges of the nodes.
+     */
+    struct Network {
+        int nbNodes;
+        int nbGraphArcs;
+        std::vector<int> offsets;
+        std::vector<int> outArcs;
+        std::vector<Graph::Node> heads;
+        std::vector<weight_type> weights;
+        // Node of the graph each node of the network comes from
+        std::vector<Graph::Node> graphNodes;
+    };
+
+    /**
+     * Build the residual network of _graph
+     */
+    static std::shared_ptr<const Network> buildNetwork(
+        const G& _graph, Disjointness _disjointness);
+
+    /**
+     * Dijkstra on the reduced weights from _s, stopping once _t is settled.
+     * Returns false if _t can not be reached.
+     */
+    bool search(Graph::Node _s, Graph::Node _t);
+
+    /**
+     * Send one unit of flow along the path to _t found by the last search
+     * and update the potentials
+     */
+    void augment(Graph::Node _s, Graph::Node _t);
+
+    /**
+     * Split the flow from _s to _t into paths, dropping the cycles
+     */
+    void decompose(Graph::Node _s, Graph::Node _t, int _nbPaths);
+
+    weight_type getReducedWeight(const int _arc, const Graph::Node _u) const {
+        return m_network->weights[_arc] + m_potentials[_u]
+               - m_potentials[m_network->heads[_arc]];
+    }
+
+    std::shared_ptr<const Network> m_network;
+    Disjointness m_disjointness;
+    int m_order;
+    // Residual capacity of each arc
+    std::vector<char> m_capacities;
+    std::vector<weight_type> m_potentials;
+    SearchWorkspace<weight_type> m_workspace;
+    std::vector<int> m_parentArcs;
+    std::vector<Graph::Node> m_settled{};
+    std::vector<std::pair<weight_type, Graph::Node>> m_heap{};
+    // Decomposition state
+    std::vector<int> m_nextArcs;
+    std::vector<int> m_positions;
+    std::vector<int> m_pathArcs{};
+    PathArena m_unsortedPaths{};
+    std::vector<weight_type> m_unsortedWeights{};
+    std::vector<std::size_t> m_sortedPaths{};
+    PathArena m_paths{};
+    std::vector<weight_type> m_weights{};
+};
+
+template <typename G>
+DisjointShortestPaths<G>::DisjointShortestPaths(
+    const G& _graph, const Disjointness _disjointness)
+    : m_network(buildNetwork(_graph, _disjointness))
+    , m_disjointness(_disjointness)
+    , m_order(_graph.getOrder())
+    , m_capacities(m_network->heads.size())
+    , m_potentials(m_network->nbNodes)
+    , m_workspace(m_network->nbNodes)
+    , m_parentArcs(m_network->nbNodes, -1)
+    , m_nextArcs(m_network->nbNodes)
+    , m_positions(m_network->nbNodes, -1) {}
+
+template <typename G>
+std::shared_ptr<const typename DisjointShortestPaths<G>::Network>
+DisjointShortestPaths<G>::buildNetwork(
+    const G& _graph, const Disjointness _disjointness) {
+    const int order = _graph.getOrder();
+    const bool split = _disjointness == Disjointness::Node;
+    auto network = std::make_shared<Network>();
+    network->nbNodes = split ? 2 * order : order;
+    network->graphNodes.resize(network->nbNodes);
+    for (Graph::Node x = 0; x < network->nbNodes; ++x) {
+        network->graphNodes[x] = x < order ? x : x - order;
+    }
+
+    // Tails are only needed during the construction
+    std::vector<Graph::Node> tails;
+    const auto addEdge = [&](const Graph::Node _u, const Graph::Node _v,
+                             const weight_type _w) {
+        tails.push_back(_u);
+        network->heads.push_back(_v);
+        network->weights.push_back(_w);
+        tails.push_back(_v);
+        network->heads.push_back(_u);
+        network->weights.push_back(-_w);
+    };
+    for (Graph::Node u = 0; u < order; ++u) {
+        for (const auto v : _graph.getNeighbors(u)) {
+            assert(_graph.getEdgeWeight(u, v) >= 0);
+            addEdge(split ? u + order : u, v, _graph.getEdgeWeight(u, v));
+        }
+    }
+    network->nbGraphArcs = static_cast<int>(tails.size());
+    if (split) {
+        for (Graph::Node u = 0; u < order; ++u) {
+            addEdge(u, u + order, weight_type(0));
+        }
+    }
+
+    network->offsets.assign(network->nbNodes + 1, 0);
+    for (const auto u : tails) {
+        ++network->offsets[u + 1];
+    }
+    std::partial_sum(network->offsets.begin(), network->offsets.end(),
+        network->offsets.begin());
+    network->outArcs.resize(tails.size());
+    std::vector<int> positions(
+        network->offsets.begin(), network->offsets.end() - 1);
+    for (int arc = 0; arc < static_cast<int>(tails.size()); ++arc) {
+        network->outArcs[positions[tails[arc]]++] = arc;
+    }
+    return network;
+}
+
+template <typename G>
+int DisjointShortestPaths<G>::computeDisjointPaths(
+    const Graph::Node _s, const Graph::Node _t, const int _k) {
+    assert(_s != _t);
+    // Forward arcs have a unit capacity and backward arcs none
+    for (std::size_t arc = 0; arc < m_capacities.size(); ++arc) {
+        m_capacities[arc] = arc % 2 == 0 ? 1 : 0;
+    }
+    std::fill(m_potentials.begin(), m_potentials.end(), weight_type(0));
+    // Paths leave s from s_out and reach t at t_in
+    const Graph::Node source =
+        m_disjointness == Disjointness::Node ? _s + m_order : _s;
+    int nbPaths = 0;
+    while (nbPaths < _k && search(source, _t)) {
+        augment(source, _t);
+        ++nbPaths;
+    }
+    decompose(source, _t, nbPaths);
+    return nbPaths;
+}
+
+template <typename G>
+bool DisjointShortestPaths<G>::search(
+    const Graph::Node _s, const Graph::Node _t) {
+    m_workspace.reset();
+    m_settled.clear();
+    m_workspace[_s].distance = 0;
+    m_heap.assign(1, {weight_type(0), _s});
+    while (!m_heap.empty()) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+        const auto [distance, u] = m_heap.back();
+        m_heap.pop_back();
+        auto& stateU = m_workspace[u];
+        if (stateU.color == 2 || distance != stateU.distance) {
+            continue;
+        }
+        stateU.color = 2;
+        m_settled.push_back(u);
+        if (u == _t) {
+            return true;
+        }
+        for (int i = m_network->offsets[u]; i < m_network->offsets[u + 1];
+             ++i) {
+            const int arc = m_network->outArcs[i];
+            const Graph::Node v = m_network->heads[arc];
+            auto& stateV = m_workspace[v];
+            if (m_capacities[arc] == 0 || stateV.color == 2) {
+                continue;
+            }
+            const weight_type distT = distance + getReducedWeight(arc, u);
+            if (distT < stateV.distance) {
+                stateV.distance = distT;
+                m_parentArcs[v] = arc;
+                m_heap.emplace_back(distT, v);
+                std::push_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+            }
+        }
+    }
+    return false;
+}
+
+template <typename G>
+void DisjointShortestPaths<G>::augment(
+    const Graph::Node _s, const Graph::Node _t) {
+    for (Graph::Node v = _t; v != _s;) {
+        const int arc = m_parentArcs[v];
+        m_capacities[arc] = 0;
+        m_capacities[arc ^ 1] = 1;
+        v = m_network->heads[arc ^ 1];
+    }
+    // Adding the distance of t to every potential changes no reduced weight
+    const weight_type distT = m_workspace.at(_t).distance;
+    for (const auto u : m_settled) {
+        m_potentials[u] += m_workspace.at(u).distance - distT;
+    }
+}
+
+template <typename G>
+void DisjointShortestPaths<G>::decompose(
+    const Graph::Node _s, const Graph::Node _t, const int _nbPaths) {
+    const auto& network = *m_network;
+    std::copy(network.offsets.begin(), network.offsets.end() - 1,
+        m_nextArcs.begin());
+    m_unsortedPaths.clear();
+    m_unsortedWeights.clear();
+    for (int p = 0; p < _nbPaths; ++p) {
+        // Follow unused forward arcs carrying flow. A node met twice closes
+        // a cycle, whose arcs are removed from the path.
+        m_pathArcs.clear();
+        m_positions[_s] = 0;
+        Graph::Node u = _s;
+        while (u != _t) {
+            int arc = network.outArcs[m_nextArcs[u]++];
+            while (arc % 2 != 0 || m_capacities[arc] != 0) {
+                arc = network.outArcs[m_nextArcs[u]++];
+            }
+            const Graph::Node v = network.heads[arc];
+            if (m_positions[v] != -1) {
+                while (static_cast<int>(m_pathArcs.size()) > m_positions[v]) {
+                    m_positions[network.heads[m_pathArcs.back()]] = -1;
+                    m_pathArcs.pop_back();
+                }
+            } else {
+                m_pathArcs.push_back(arc);
+                m_positions[v] = static_cast<int>(m_pathArcs.size());
+            }
+            u = v;
+        }
+
+        weight_type weight(0);
+        m_unsortedPaths.append(network.graphNodes[_s]);
+        m_positions[_s] = -1;
+        for (const auto arc : m_pathArcs) {
+            m_positions[network.heads[arc]] = -1;
+            weight += network.weights[arc];
+            // Split arcs lead to the same node of the graph
+            if (arc < network.nbGraphArcs) {
+                m_unsortedPaths.append(network.graphNodes[network.heads[arc]]);
+            }
+        }
+        m_unsortedPaths.closePath();
+        m_unsortedWeights.push_back(weight);
+    }
+
+    m_sortedPaths.resize(m_unsortedWeights.size());
+    std::iota(m_sortedPaths.begin(), m_sortedPaths.end(), 0);
+    std::stable_sort(m_sortedPaths.begin(), m_sortedPaths.end(),
+        [&](const std::size_t _i, const std::size_t _j) {
+            return m_unsortedWeights[_i] < m_unsortedWeights[_j];
+        });
+    m_paths.clear();
+    m_weights.clear();
+    for (const auto i : m_sortedPaths) {
+        const auto path = m_unsortedPaths[i];
+        m_paths.push(path.begin(), path.end());
+        m_weights.push_back(m_unsortedWeights[i]);
+    }
+}
+
+template <typename G>
+void DisjointShortestPaths<G>::computeDisjointPaths(
+    const std::vector<Demand>& _demands, const int _k,
+    std::vector<PathArena>& _paths, std::vector<weight_type>& _weights,
+    const int _nbThreads) const {
+    _paths.resize(_demands.size());
+    _weights.resize(_demands.size());
+#pragma omp parallel num_threads(_nbThreads)
+    {
+        DisjointShortestPaths solver(*this);
+#pragma omp for schedule(dynamic)
+        for (std::size_t i = 0; i < _demands.size(); ++i) {
+            solver.computeDisjointPaths(
+                _demands[i].source, _demands[i].target, _k);
+            _paths[i].clear();
+            for (std::size_t j = 0; j < solver.getPaths().size(); ++j) {
+                const auto path = solver.getPaths()[j];
+                _paths[i].push(path.begin(), path.end());
+            }
+            _weights[i] = solver.getTotalWeight();
+        }
+    }
+}
+
+#endif
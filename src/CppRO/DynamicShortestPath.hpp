@@ -0,0 +1,263 @@
+#ifndef DYNAMICSHORTESTPATH_HPP
+#define DYNAMICSHORTESTPATH_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "Graph.hpp"
+
+/**
+ * Single source shortest path tree kept up to date when edge weights change,
+ * in the spirit of Ramalingam and Reps.
+ *
+ * Weight changes go through setEdgeWeight and addEdgeWeight, which update the
+ * graph and record the edge. update() then repairs the tree: the subtrees
+ * hanging from an edge whose weight increased are invalidated and reconnected
+ * from their unaffected in-neighbors, and the decreased edges are relaxed.
+ * Only the nodes whose distance may change are visited.
+ *
+ * Edge weights must be non negative and the edges of the graph must not be
+ * added or removed after construction.
+ */
+template <typename G>
+class DynamicShortestPath {
+  public:
+    using weight_type = typename G::weight_type;
+
+    DynamicShortestPath(G& _graph, Graph::Node _s);
+
+    DynamicShortestPath(const DynamicShortestPath&) = default;
+    DynamicShortestPath& operator=(const DynamicShortestPath&) = default;
+    DynamicShortestPath(DynamicShortestPath&&) noexcept = default;
+    DynamicShortestPath& operator=(DynamicShortestPath&&) noexcept = default;
+    ~DynamicShortestPath() = default;
+
+    Graph::Node getSource() const { return m_source; }
+
+    weight_type getDistance(const Graph::Node _u) const {
+        return m_distance[_u];
+    }
+
+    Graph::Node getParent(const Graph::Node _u) const { return m_parent[_u]; }
+
+    /**
+     * \brief Returns the shortest path from the source to _t, empty if _t is
+     * not reachable. Pending weight changes are not taken into account.
+     */
+    Graph::Path getShortestPath(Graph::Node _t) const;
+
+    void setEdgeWeight(
+        const Graph::Node _u, const Graph::Node _v, const weight_type& _w) {
+        assert(_w >= 0);
+        m_graph->setEdgeWeight(_u, _v, _w);
+        m_changedEdges.emplace_back(_u, _v);
+    }
+
+    void addEdgeWeight(
+        const Graph::Node _u, const Graph::Node _v, const weight_type& _w) {
+        m_graph->addEdgeWeight(_u, _v, _w);
+        assert(m_graph->getEdgeWeight(_u, _v) >= 0);
+        m_changedEdges.emplace_back(_u, _v);
+    }
+
+    /**
+     * \brief Recompute the whole tree, dropping the pending weight changes
+     */
+    void computeShortestPathTree();
+
+    /**
+     * \brief Repair the tree after the pending weight changes
+     * Returns the number of nodes whose distance was reset or updated.
+     */
+    int update();
+
+    /**
+     * \brief Number of nodes touched by the last update or computation
+     */
+    int getNbTouchedNodes() const {
+        return static_cast<int>(m_touched.size());
+    }
+
+    /**
+     * \brief Nodes touched by the last update or computation
+     */
+    const std::vector<Graph::Node>& getTouchedNodes() const {
+        return m_touched;
+    }
+
+  private:
+    void touch(const Graph::Node _u) {
+        if (!m_isTouched[_u]) {
+            m_isTouched[_u] = 1;
+            m_touched.push_back(_u);
+        }
+    }
+
+    /**
+     * Lower the distance of _v to _distance through _parent and queue it
+     */
+    void relax(Graph::Node _v, Graph::Node _parent, weight_type _distance);
+
+    /**
+     * Invalidate the subtree rooted at _root and append its nodes to
+     * m_invalidated
+     */
+    void invalidateSubtree(Graph::Node _root);
+
+    /**
+     * Dijkstra from the queued nodes
+     */
+    void propagate();
+
+    G* m_graph;
+    Graph::Node m_source;
+    std::vector<weight_type> m_distance;
+    std::vector<Graph::Node> m_parent;
+    std::vector<std::vector<Graph::Node>> m_inNeighbors;
+    std::vector<Graph::Edge> m_changedEdges{};
+    // Min heap of (distance, node), with outdated entries skipped when popped
+    std::vector<std::pair<weight_type, Graph::Node>> m_heap{};
+    std::vector<char> m_isTouched;
+    std::vector<Graph::Node> m_touched{};
+    std::vector<char> m_isInvalidated;
+    std::vector<Graph::Node> m_invalidated{};
+};
+
+template <typename G>
+DynamicShortestPath<G>::DynamicShortestPath(G& _graph, const Graph::Node _s)
+    : m_graph(&_graph)
+    , m_source(_s)
+    , m_distance(_graph.getOrder(), std::numeric_limits<weight_type>::max())
+    , m_parent(_graph.getOrder(), -1)
+    , m_inNeighbors(_graph.getOrder())
+    , m_isTouched(_graph.getOrder(), 0)
+    , m_isInvalidated(_graph.getOrder(), 0) {
+    for (Graph::Node u = 0; u < _graph.getOrder(); ++u) {
+        for (const auto v : _graph.getNeighbors(u)) {
+            m_inNeighbors[v].push_back(u);
+        }
+    }
+    computeShortestPathTree();
+}
+
+template <typename G>
+Graph::Path DynamicShortestPath<G>::getShortestPath(
+    const Graph::Node _t) const {
+    Graph::Path path;
+    if (m_parent[_t] != -1) {
+        Graph::Node node = _t;
+        while (node != m_source) {
+            path.push_back(node);
+            node = m_parent[node];
+        }
+        path.push_back(node);
+        std::reverse(path.begin(), path.end());
+    }
+    return path;
+}
+
+template <typename G>
+void DynamicShortestPath<G>::computeShortestPathTree() {
+    std::fill(m_distance.begin(), m_distance.end(),
+        std::numeric_limits<weight_type>::max());
+    std::fill(m_parent.begin(), m_parent.end(), -1);
+    m_changedEdges.clear();
+    for (const auto u : m_touched) {
+        m_isTouched[u] = 0;
+    }
+    m_touched.clear();
+    relax(m_source, m_source, 0);
+    propagate();
+}
+
+template <typename G>
+int DynamicShortestPath<G>::update() {
+    for (const auto u : m_touched) {
+        m_isTouched[u] = 0;
+    }
+    m_touched.clear();
+
+    // Tree edges that got heavier disconnect their subtree
+    for (const auto& [u, v] : m_changedEdges) {
+        if (m_parent[v] == u && u != v && !m_isInvalidated[u]
+            && !m_isInvalidated[v]
+            && m_distance[u] + m_graph->getEdgeWeight(u, v) > m_distance[v]) {
+            invalidateSubtree(v);
+        }
+    }
+    // Reconnect the invalidated nodes from the rest of the tree
+    for (const auto v : m_invalidated) {
+        for (const auto u : m_inNeighbors[v]) {
+            if (!m_isInvalidated[u] && m_parent[u] != -1) {
+                relax(v, u, m_distance[u] + m_graph->getEdgeWeight(u, v));
+            }
+        }
+    }
+    // Edges that got lighter
+    for (const auto& [u, v] : m_changedEdges) {
+        if (!m_isInvalidated[u] && m_parent[u] != -1) {
+            relax(v, u, m_distance[u] + m_graph->getEdgeWeight(u, v));
+        }
+    }
+    for (const auto v : m_invalidated) {
+        m_isInvalidated[v] = 0;
+    }
+    m_invalidated.clear();
+    m_changedEdges.clear();
+
+    propagate();
+    return getNbTouchedNodes();
+}
+
+template <typename G>
+void DynamicShortestPath<G>::relax(const Graph::Node _v,
+    const Graph::Node _parent, const weight_type _distance) {
+    if (_distance < m_distance[_v]) {
+        m_distance[_v] = _distance;
+        m_parent[_v] = _parent;
+        touch(_v);
+        m_heap.emplace_back(_distance, _v);
+        std::push_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+    }
+}
+
+template <typename G>
+void DynamicShortestPath<G>::invalidateSubtree(const Graph::Node _root) {
+    // The children of a node are the neighbors it is the parent of
+    std::size_t first = m_invalidated.size();
+    m_isInvalidated[_root] = 1;
+    m_invalidated.push_back(_root);
+    while (first < m_invalidated.size()) {
+        const auto u = m_invalidated[first++];
+        for (const auto v : m_graph->getNeighbors(u)) {
+            if (m_parent[v] == u && !m_isInvalidated[v]) {
+                m_isInvalidated[v] = 1;
+                m_invalidated.push_back(v);
+            }
+        }
+        m_distance[u] = std::numeric_limits<weight_type>::max();
+        m_parent[u] = -1;
+        touch(u);
+    }
+}
+
+template <typename G>
+void DynamicShortestPath<G>::propagate() {
+    while (!m_heap.empty()) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+        const auto [distance, u] = m_heap.back();
+        m_heap.pop_back();
+        if (distance != m_distance[u]) {
+            continue;
+        }
+        for (const auto v : m_graph->getNeighbors(u)) {
+            relax(v, u, distance + m_graph->getEdgeWeight(u, v));
+        }
+    }
+}
+
+#endif
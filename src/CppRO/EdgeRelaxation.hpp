@@ -0,0 +1,262 @@
+#ifndef EDGERELAXATION_HPP
+#define EDGERELAXATION_HPP
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define CPPRO_X86_KERNELS
+#endif
+
+#include "Graph.hpp"
+
+/**
+ * Edges stored as three parallel arrays (structure of arrays), so a sweep
+ * over the edges reads contiguous memory instead of going through the
+ * adjacency structure of the graph.
+ */
+template <typename W>
+struct EdgeArrays {
+    std::vector<std::int32_t> src{};
+    std::vector<std::int32_t> dst{};
+    std::vector<W> weight{};
+
+    template <typename G>
+    static EdgeArrays fromGraph(const G& _graph) {
+        EdgeArrays edges;
+        edges.assign(_graph);
+        return edges;
+    }
+
+    /**
+     * \brief Replace the edges by the ones of _graph, sorted by tail, keeping
+     * the capacity
+     */
+    template <typename G>
+    void assign(const G& _graph) {
+        clear();
+        reserve(_graph.size());
+        for (Graph::Node u = 0; u < _graph.getOrder(); ++u) {
+            for (const auto v : _graph.getNeighbors(u)) {
+                push_back(u, v, _graph.getEdgeWeight(u, v));
+            }
+        }
+    }
+
+    void clear() {
+        src.clear();
+        dst.clear();
+        weight.clear();
+    }
+
+    void reserve(const std::size_t _nbEdges) {
+        src.reserve(_nbEdges);
+        dst.reserve(_nbEdges);
+        weight.reserve(_nbEdges);
+    }
+
+    void push_back(const Graph::Node _u, const Graph::Node _v, const W& _w) {
+        src.push_back(_u);
+        dst.push_back(_v);
+        weight.push_back(_w);
+    }
+
+    std::size_t size() const { return src.size(); }
+};
+
+enum class RelaxationKernel { Scalar, AVX2, AVX512 };
+
+/**
+ * \brief Returns the fastest relaxation kernel supported by the CPU for the
+ * weight type W
+ */
+template <typename W>
+RelaxationKernel getBestRelaxationKernel() {
+#ifdef CPPRO_X86_KERNELS
+    if constexpr (std::is_same_v<W, double>) {
+        if (__builtin_cpu_supports("avx512f")) {
+            return RelaxationKernel::AVX512;
+        }
+    }
+    if constexpr (std::is_same_v<W, double>
+                  || std::is_same_v<W, std::int32_t>) {
+        if (__builtin_cpu_supports("avx2")) {
+            return RelaxationKernel::AVX2;
+        }
+    }
+#endif
+    return RelaxationKernel::Scalar;
+}
+
+namespace detail {
+/**
+ * Relax the edge _i if it improves the distance of its head. Unreached nodes
+ * have a distance of std::numeric_limits<W>::max().
+ */
+template <typename W>
+inline bool relaxEdge(const EdgeArrays<W>& _edges, const std::size_t _i,
+    std::vector<W>& _distance, std::vector<Graph::Node>& _parent) {
+    const auto u = _edges.src[_i];
+    const auto v = _edges.dst[_i];
+    if (_distance[u] == std::numeric_limits<W>::max()) {
+        return false;
+    }
+    const W dist = _distance[u] + _edges.weight[_i];
+    if (dist < _distance[v]) {
+        _distance[v] = dist;
+        _parent[v] = u;
+        return true;
+    }
+    return false;
+}
+
+template <typename W>
+bool relaxEdgesScalar(const EdgeArrays<W>& _edges, const std::size_t _first,
+    std::vector<W>& _distance, std::vector<Graph::Node>& _parent) {
+    bool anyChange = false;
+    for (std::size_t i = _first; i < _edges.size(); ++i) {
+        anyChange |= relaxEdge(_edges, i, _distance, _parent);
+    }
+    return anyChange;
+}
+
+// The vector kernels gather the distances of the tails and heads of a block of
+// edges and only go back to scalar code for the edges that improve their
+// head, which become rare after the first sweeps. Edges of a block sharing a
+// head are handled correctly since the scalar code checks them again.
+#ifdef CPPRO_X86_KERNELS
+__attribute__((target("avx2"))) inline bool relaxEdgesAVX2(
+    const EdgeArrays<double>& _edges, std::vector<double>& _distance,
+    std::vector<Graph::Node>& _parent) {
+    const std::size_t nbEdges = _edges.size();
+    const double* distance = _distance.data();
+    const __m256d infinity =
+        _mm256_set1_pd(std::numeric_limits<double>::max());
+    // The masked gathers avoid reading an undefined source register
+    const __m256d allLanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    bool anyChange = false;
+    std::size_t i = 0;
+    for (; i + 4 <= nbEdges; i += 4) {
+        const __m128i src = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(_edges.src.data() + i));
+        const __m128i dst = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(_edges.dst.data() + i));
+        const __m256d distSrc = _mm256_mask_i32gather_pd(
+            _mm256_setzero_pd(), distance, src, allLanes, 8);
+        const __m256d distDst = _mm256_mask_i32gather_pd(
+            _mm256_setzero_pd(), distance, dst, allLanes, 8);
+        const __m256d dist =
+            _mm256_add_pd(distSrc, _mm256_loadu_pd(_edges.weight.data() + i));
+        const __m256d improves =
+            _mm256_and_pd(_mm256_cmp_pd(dist, distDst, _CMP_LT_OQ),
+                _mm256_cmp_pd(distSrc, infinity, _CMP_NEQ_OQ));
+        int mask = _mm256_movemask_pd(improves);
+        while (mask != 0) {
+            const int lane = __builtin_ctz(mask);
+            mask &= mask - 1;
+            anyChange |= relaxEdge(_edges, i + lane, _distance, _parent);
+        }
+    }
+    return relaxEdgesScalar(_edges, i, _distance, _parent) || anyChange;
+}
+
+__attribute__((target("avx2"))) inline bool relaxEdgesAVX2(
+    const EdgeArrays<std::int32_t>& _edges,
+    std::vector<std::int32_t>& _distance, std::vector<Graph::Node>& _parent) {
+    const std::size_t nbEdges = _edges.size();
+    const int* distance = _distance.data();
+    const __m256i infinity =
+        _mm256_set1_epi32(std::numeric_limits<std::int32_t>::max());
+    bool anyChange = false;
+    std::size_t i = 0;
+    for (; i + 8 <= nbEdges; i += 8) {
+        const __m256i src = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(_edges.src.data() + i));
+        const __m256i dst = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(_edges.dst.data() + i));
+        const __m256i distSrc = _mm256_i32gather_epi32(distance, src, 4);
+        const __m256i distDst = _mm256_i32gather_epi32(distance, dst, 4);
+        // Wraps around for unreached tails, which are masked out
+        const __m256i dist = _mm256_add_epi32(distSrc,
+            _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(_edges.weight.data() + i)));
+        const __m256i improves =
+            _mm256_andnot_si256(_mm256_cmpeq_epi32(distSrc, infinity),
+                _mm256_cmpgt_epi32(distDst, dist));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(improves));
+        while (mask != 0) {
+            const int lane = __builtin_ctz(mask);
+            mask &= mask - 1;
+            anyChange |= relaxEdge(_edges, i + lane, _distance, _parent);
+        }
+    }
+    return relaxEdgesScalar(_edges, i, _distance, _parent) || anyChange;
+}
+
+__attribute__((target("avx512f"))) inline bool relaxEdgesAVX512(
+    const EdgeArrays<double>& _edges, std::vector<double>& _distance,
+    std::vector<Graph::Node>& _parent) {
+    const std::size_t nbEdges = _edges.size();
+    const double* distance = _distance.data();
+    const __m512d infinity =
+        _mm512_set1_pd(std::numeric_limits<double>::max());
+    bool anyChange = false;
+    std::size_t i = 0;
+    for (; i + 8 <= nbEdges; i += 8) {
+        const __m256i src = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(_edges.src.data() + i));
+        const __m256i dst = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(_edges.dst.data() + i));
+        const __m512d distSrc = _mm512_mask_i32gather_pd(
+            _mm512_setzero_pd(), 0xFF, src, distance, 8);
+        const __m512d distDst = _mm512_mask_i32gather_pd(
+            _mm512_setzero_pd(), 0xFF, dst, distance, 8);
+        const __m512d dist =
+            _mm512_add_pd(distSrc, _mm512_loadu_pd(_edges.weight.data() + i));
+        unsigned int mask =
+            _mm512_cmp_pd_mask(dist, distDst, _CMP_LT_OQ)
+            & _mm512_cmp_pd_mask(distSrc, infinity, _CMP_NEQ_OQ);
+        while (mask != 0) {
+            const int lane = __builtin_ctz(mask);
+            mask &= mask - 1;
+            anyChange |= relaxEdge(_edges, i + lane, _distance, _parent);
+        }
+    }
+    return relaxEdgesScalar(_edges, i, _distance, _parent) || anyChange;
+}
+#endif
+} // namespace detail
+
+/**
+ * \brief Relax every edge once and returns true if a distance decreased
+ * The vector kernels read the distances of a block of edges at once, so an
+ * improvement made inside a block may only be used by the next sweep.
+ * _kernel must be supported by the CPU, see getBestRelaxationKernel. The
+ * vector kernels are available for double (AVX2 and AVX-512) and int32 (AVX2)
+ * weights; the other types always use the scalar loop.
+ */
+template <typename W>
+bool relaxEdges(const EdgeArrays<W>& _edges, std::vector<W>& _distance,
+    std::vector<Graph::Node>& _parent,
+    [[maybe_unused]] const RelaxationKernel _kernel =
+        getBestRelaxationKernel<W>()) {
+#ifdef CPPRO_X86_KERNELS
+    if constexpr (std::is_same_v<W, double>) {
+        if (_kernel == RelaxationKernel::AVX512) {
+            return detail::relaxEdgesAVX512(_edges, _distance, _parent);
+        }
+    }
+    if constexpr (std::is_same_v<W, double>
+                  || std::is_same_v<W, std::int32_t>) {
+        if (_kernel == RelaxationKernel::AVX2) {
+            return detail::relaxEdgesAVX2(_edges, _distance, _parent);
+        }
+    }
+#endif
+    return detail::relaxEdgesScalar(_edges, 0, _distance, _parent);
+}
+
+#endif
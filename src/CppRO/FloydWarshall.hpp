@@ -0,0 +1,188 @@
+#ifndef FLOYDWARSHALL_HPP
+#define FLOYDWARSHALL_HPP
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include <omp.h>
+
+#include "Graph.hpp"
+#include "Matrix.hpp"
+
+/**
+ * All pairs shortest paths of a dense graph with a cache blocked
+ * Floyd-Warshall.
+ *
+ * The matrices are cut into BLOCK_SIZE x BLOCK_SIZE tiles. For each block of
+ * intermediate nodes, the diagonal tile is updated first, then the tiles of
+ * its row and column, which only depend on it, and finally all the remaining
+ * tiles, which are independent of each other. The last two phases are spread
+ * over the threads.
+ *
+ * Matrix is column major, so the inner min-plus loop runs down a column,
+ * d(., j) = min(d(., j), d(., k) + d(k, j)), on contiguous memory with a
+ * single broadcast value and is vectorized.
+ *
+ * The next hop matrix gives the node following s on a shortest path to t, s
+ * itself if s == t and -1 if t can not be reached.
+ */
+template <typename W>
+class FloydWarshall {
+  public:
+    static constexpr int BLOCK_SIZE = 64;
+
+    /**
+     * \brief Distance of the unreachable pairs
+     * Integer distances use half of the maximum so that adding two distances
+     * does not overflow; the weight of a path must stay below it.
+     */
+    static constexpr W infinity() {
+        if constexpr (std::is_floating_point_v<W>) {
+            return std::numeric_limits<W>::max();
+        } else {
+            return std::numeric_limits<W>::max() / 2;
+        }
+    }
+
+    template <typename G>
+    explicit FloydWarshall(const G& _graph);
+
+    /**
+     * \brief Compute the shortest paths between every pair of nodes
+     * Returns false if the graph has a negative cycle, in which case the
+     * computation stops early and the matrices are meaningless.
+     */
+    bool computeAllShortestPaths(int _nbThreads = omp_get_max_threads());
+
+    W getDistance(const Graph::Node _s, const Graph::Node _t) const {
+        return m_distance(_s, _t);
+    }
+
+    Graph::Node getNextHop(const Graph::Node _s, const Graph::Node _t) const {
+        return m_nextHop(_s, _t);
+    }
+
+    const Matrix<W>& getDistance() const { return m_distance; }
+
+    const Matrix<Graph::Node>& getNextHop() const { return m_nextHop; }
+
+  private:
+    int getBlockEnd(const int _block) const {
+        return std::min(m_distance.size1(), (_block + 1) * BLOCK_SIZE);
+    }
+
+    /**
+     * Relax the tile (_iBlock, _jBlock) through the nodes of _kBlock
+     */
+    void relaxTile(const int _kBlock, const int _iBlock, const int _jBlock) {
+        for (int k = _kBlock * BLOCK_SIZE; k < getBlockEnd(_kBlock); ++k) {
+            relaxTileThrough(k, _iBlock, _jBlock);
+        }
+    }
+
+    /**
+     * Relax the tile (_iBlock, _jBlock) through the node _k
+     */
+    void relaxTileThrough(int _k, int _iBlock, int _jBlock);
+
+    Matrix<W> m_distance;
+    Matrix<Graph::Node> m_nextHop;
+};
+
+template <typename W>
+template <typename G>
+FloydWarshall<W>::FloydWarshall(const G& _graph)
+    : m_distance(_graph.getOrder(), _graph.getOrder(), infinity())
+    , m_nextHop(_graph.getOrder(), _graph.getOrder(), -1) {
+    for (Graph::Node u = 0; u < _graph.getOrder(); ++u) {
+        m_distance(u, u) = 0;
+        m_nextHop(u, u) = u;
+    }
+    for (Graph::Node u = 0; u < _graph.getOrder(); ++u) {
+        for (const auto v : _graph.getNeighbors(u)) {
+            const auto weight = static_cast<W>(_graph.getEdgeWeight(u, v));
+            if (weight < m_distance(u, v)) {
+                m_distance(u, v) = weight;
+                m_nextHop(u, v) = v;
+            }
+        }
+    }
+}
+
+template <typename W>
+bool FloydWarshall<W>::computeAllShortestPaths(const int _nbThreads) {
+    const int order = m_distance.size1();
+    const int nbBlocks = (order + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    bool hasNegativeCycle = false;
+#pragma omp parallel num_threads(_nbThreads)
+    for (int kBlock = 0; kBlock < nbBlocks; ++kBlock) {
+        // When k is reached, d(k, k) only goes through the nodes before k, so
+        // the first negative cycle is caught at its last node, before any
+        // relaxation through it can make the distances overflow
+#pragma omp single
+        for (int k = kBlock * BLOCK_SIZE;
+             k < getBlockEnd(kBlock) && !hasNegativeCycle; ++k) {
+            hasNegativeCycle = m_distance(k, k) < 0;
+            if (!hasNegativeCycle) {
+                relaxTileThrough(k, kBlock, kBlock);
+            }
+        }
+        if (hasNegativeCycle) {
+            break;
+        }
+        // Even indices are the tiles of the row of kBlock, odd ones the tiles
+        // of its column
+#pragma omp for schedule(dynamic)
+        for (int tile = 0; tile < 2 * nbBlocks; ++tile) {
+            const int block = tile / 2;
+            if (block == kBlock) {
+                continue;
+            }
+            if (tile % 2 == 0) {
+                relaxTile(kBlock, kBlock, block);
+            } else {
+                relaxTile(kBlock, block, kBlock);
+            }
+        }
+#pragma omp for collapse(2) schedule(dynamic)
+        for (int jBlock = 0; jBlock < nbBlocks; ++jBlock) {
+            for (int iBlock = 0; iBlock < nbBlocks; ++iBlock) {
+                if (iBlock != kBlock && jBlock != kBlock) {
+                    relaxTile(kBlock, iBlock, jBlock);
+                }
+            }
+        }
+    }
+    return !hasNegativeCycle;
+}
+
+template <typename W>
+void FloydWarshall<W>::relaxTileThrough(
+    const int _k, const int _iBlock, const int _jBlock) {
+    const int iBegin = _iBlock * BLOCK_SIZE;
+    const int iEnd = getBlockEnd(_iBlock);
+    const int jEnd = getBlockEnd(_jBlock);
+    const W* distanceK = &m_distance(0, _k);
+    const Graph::Node* nextHopK = &m_nextHop(0, _k);
+    for (int j = _jBlock * BLOCK_SIZE; j < jEnd; ++j) {
+        const W distanceKJ = m_distance(_k, j);
+        if (distanceKJ == infinity()) {
+            continue;
+        }
+        // distanceJ and distanceK are the same column when j == _k, which is
+        // fine since each lane only reads and writes its own row
+        W* distanceJ = &m_distance(0, j);
+        Graph::Node* nextHopJ = &m_nextHop(0, j);
+#pragma omp simd
+        for (int i = iBegin; i < iEnd; ++i) {
+            const W distance = distanceK[i] + distanceKJ;
+            const bool improves =
+                distanceK[i] != infinity() && distance < distanceJ[i];
+            distanceJ[i] = improves ? distance : distanceJ[i];
+            nextHopJ[i] = improves ? nextHopK[i] : nextHopJ[i];
+        }
+    }
+}
+
+#endif
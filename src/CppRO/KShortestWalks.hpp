@@ -0,0 +1,290 @@
+#ifndef KSHORTESTWALKS_HPP
+#define KSHORTESTWALKS_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Graph.hpp"
+#include "ShortestPath.hpp"
+
+/**
+ * Lazy enumeration of the shortest walks (paths that may contain cycles) from
+ * a source to any node, by increasing weight, using the recursive enumeration
+ * algorithm of Jiménez and Marzal.
+ *
+ * A single shortest path tree is computed. The k-th shortest walk to v is then
+ * stored as the k'-th shortest walk to a predecessor u followed by (u, v), and
+ * the next walk to v is chosen among the candidates of v, which only requires
+ * the next walk to u. Walks are only computed when asked for, so stopping
+ * early does not pay for the unused ones, and walks to different targets share
+ * their prefixes.
+ *
+ * Edge weights must be non negative.
+ */
+template <typename G>
+class KShortestWalks {
+  public:
+    using weight_type = typename G::weight_type;
+
+    struct Walk {
+        weight_type cost;
+        Graph::Path path;
+    };
+
+    /**
+     * Input iterator over the walks to a target, by increasing weight. The
+     * next walk is computed on increment.
+     */
+    class iterator {
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Walk;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Walk*;
+        using reference = const Walk&;
+
+        iterator() = default;
+        iterator(KShortestWalks* _walks, const Graph::Node _t)
+            : m_walks(_walks)
+            , m_target(_t) {
+            load();
+        }
+
+        reference operator*() const { return m_walk; }
+
+        pointer operator->() const { return &m_walk; }
+
+        /**
+         * \brief Rank of the current walk, starting from 0
+         */
+        std::size_t getIndex() const { return m_index; }
+
+        iterator& operator++() {
+            ++m_index;
+            load();
+            return *this;
+        }
+
+        bool operator==(const iterator& _other) const {
+            return m_walks == _other.m_walks
+                   && (m_walks == nullptr || m_index == _other.m_index);
+        }
+
+      private:
+        void load() {
+            if (m_walks->computeWalk(m_target, m_index)) {
+                m_walk.cost = m_walks->getCost(m_target, m_index);
+                m_walks->getWalk(m_target, m_index, m_walk.path);
+            } else {
+                m_walks = nullptr;
+            }
+        }
+
+        KShortestWalks* m_walks{nullptr};
+        Graph::Node m_target{-1};
+        std::size_t m_index{0};
+        Walk m_walk{};
+    };
+
+    class Range {
+      public:
+        Range(KShortestWalks* _walks, const Graph::Node _t)
+            : m_walks(_walks)
+            , m_target(_t) {}
+
+        iterator begin() const { return {m_walks, m_target}; }
+
+        iterator end() const { return {}; }
+
+      private:
+        KShortestWalks* m_walks;
+        Graph::Node m_target;
+    };
+
+    KShortestWalks(const G& _graph, Graph::Node _s);
+
+    Graph::Node getSource() const { return m_source; }
+
+    /**
+     * \brief Compute the walks to _t up to the _k-th one (starting from 0) if
+     * they are not known yet. Returns false if there are at most _k walks to
+     * _t.
+     */
+    bool computeWalk(Graph::Node _t, std::size_t _k);
+
+    /**
+     * \brief Number of walks to _t computed so far
+     */
+    std::size_t getNbWalks(const Graph::Node _t) const {
+        return m_walks[_t].size();
+    }
+
+    /**
+     * \brief Weight of the _k-th walk to _t, which must have been computed
+     */
+    weight_type getCost(const Graph::Node _t, const std::size_t _k) const {
+        assert(_k < m_walks[_t].size());
+        return m_walks[_t][_k].cost;
+    }
+
+    /**
+     * \brief Write the _k-th walk to _t, which must have been computed, into
+     * _path. _path keeps its capacity.
+     */
+    void getWalk(Graph::Node _t, std::size_t _k, Graph::Path& _path) const;
+
+    /**
+     * \brief Returns the walks to _t by increasing weight, computed while
+     * iterating
+     */
+    Range getWalks(const Graph::Node _t) { return {this, _t}; }
+
+  private:
+    /**
+     * A walk to v, made of the walk predIndex to pred followed by (pred, v).
+     * The walk to the source of length 0 has no predecessor.
+     */
+    struct WalkEntry {
+        weight_type cost;
+        Graph::Node pred;
+        std::size_t predIndex;
+    };
+
+    static bool isWorse(const WalkEntry& _w1, const WalkEntry& _w2) {
+        return std::tie(_w1.cost, _w1.pred, _w1.predIndex)
+               > std::tie(_w2.cost, _w2.pred, _w2.predIndex);
+    }
+
+    void pushCandidate(const Graph::Node _v, const WalkEntry& _walk) {
+        m_candidates[_v].push_back(_walk);
+        std::push_heap(
+            m_candidates[_v].begin(), m_candidates[_v].end(), &isWorse);
+    }
+
+    /**
+     * Compute the next walk to _v and the ones it depends on
+     */
+    void computeNextWalk(Graph::Node _v);
+
+    G const* m_graph;
+    Graph::Node m_source;
+    // m_inEdges[v] = {(u, w(u, v))}
+    std::vector<std::vector<std::pair<Graph::Node, weight_type>>> m_inEdges;
+    std::vector<std::vector<WalkEntry>> m_walks;
+    // Heaps of the candidates for the next walk to each node
+    std::vector<std::vector<WalkEntry>> m_candidates;
+    std::vector<char> m_initialized;
+    std::vector<char> m_exhausted;
+    std::vector<Graph::Node> m_stack{};
+};
+
+template <typename G>
+KShortestWalks<G>::KShortestWalks(const G& _graph, const Graph::Node _s)
+    : m_graph(&_graph)
+    , m_source(_s)
+    , m_inEdges(_graph.getOrder())
+    , m_walks(_graph.getOrder())
+    , m_candidates(_graph.getOrder())
+    , m_initialized(_graph.getOrder(), 0)
+    , m_exhausted(_graph.getOrder(), 0) {
+    for (Graph::Node u = 0; u < _graph.getOrder(); ++u) {
+        for (const auto v : _graph.getNeighbors(u)) {
+            assert(_graph.getEdgeWeight(u, v) >= 0);
+            m_inEdges[v].emplace_back(u, _graph.getEdgeWeight(u, v));
+        }
+    }
+
+    ShortestPath<G> shortestPath(_graph);
+    shortestPath.computeShortestPathTree(_s);
+    for (Graph::Node v = 0; v < _graph.getOrder(); ++v) {
+        const auto parent = shortestPath.getParent(v);
+        if (v == _s) {
+            m_walks[v].push_back({0, -1, 0});
+        } else if (parent != -1) {
+            m_walks[v].push_back({shortestPath.getDistance(v), parent, 0});
+        } else {
+            m_exhausted[v] = 1;
+        }
+    }
+}
+
+template <typename G>
+bool KShortestWalks<G>::computeWalk(
+    const Graph::Node _t, const std::size_t _k) {
+    while (m_walks[_t].size() <= _k && !m_exhausted[_t]) {
+        computeNextWalk(_t);
+    }
+    return _k < m_walks[_t].size();
+}
+
+template <typename G>
+void KShortestWalks<G>::getWalk(
+    const Graph::Node _t, const std::size_t _k, Graph::Path& _path) const {
+    assert(_k < m_walks[_t].size());
+    _path.clear();
+    Graph::Node node = _t;
+    std::size_t index = _k;
+    while (node != -1) {
+        _path.push_back(node);
+        const auto& walk = m_walks[node][index];
+        node = walk.pred;
+        index = walk.predIndex;
+    }
+    std::reverse(_path.begin(), _path.end());
+}
+
+template <typename G>
+void KShortestWalks<G>::computeNextWalk(const Graph::Node _v) {
+    // The recursion of the original algorithm goes along the last walk of the
+    // node, so it is unrolled with a stack. A node can not be on the stack
+    // twice since the walks it depends on are shorter than its last walk.
+    m_stack.push_back(_v);
+    while (!m_stack.empty()) {
+        const auto v = m_stack.back();
+        if (!m_initialized[v]) {
+            // Every first walk to a predecessor extended to v, except the
+            // first walk to v
+            m_initialized[v] = 1;
+            const auto& first = m_walks[v].front();
+            for (const auto& [u, weight] : m_inEdges[v]) {
+                if (u != first.pred && !m_walks[u].empty()) {
+                    pushCandidate(v, {m_walks[u].front().cost + weight, u, 0});
+                }
+            }
+        }
+
+        // The walk following the predecessor's part of the last walk to v
+        // is the only new candidate
+        const auto& last = m_walks[v].back();
+        if (last.pred != -1) {
+            const auto u = last.pred;
+            const auto nextIndex = last.predIndex + 1;
+            if (m_walks[u].size() == nextIndex && !m_exhausted[u]) {
+                m_stack.push_back(u);
+                continue;
+            }
+            if (nextIndex < m_walks[u].size()) {
+                pushCandidate(v, {m_walks[u][nextIndex].cost
+                                         + m_graph->getEdgeWeight(u, v),
+                                     u, nextIndex});
+            }
+        }
+
+        auto& candidates = m_candidates[v];
+        if (candidates.empty()) {
+            m_exhausted[v] = 1;
+        } else {
+            std::pop_heap(candidates.begin(), candidates.end(), &isWorse);
+            m_walks[v].push_back(candidates.back());
+            candidates.pop_back();
+        }
+        m_stack.pop_back();
+    }
+}
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef LAGRANGIANSHORTESTPATH_HPP
+#define LAGRANGIANSHORTESTPATH_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include "Graph.hpp"
+#include "ShortestPath.hpp"
+
+/**
+ * Delay constrained shortest path heuristic by Lagrangian relaxation, with the
+ * LARAC algorithm of Jüttner et al.
+ *
+ * The delay constraint is moved to the objective with a multiplier lambda,
+ * and each iteration is a Dijkstra on cost + lambda * delay. The multiplier is
+ * set so that the cheapest path known and the fastest feasible path known
+ * have the same aggregated weight, until no path beats them. The result is the
+ * best feasible path found, together with the best Lagrangian lower bound
+ * max_lambda min_p cost(p) + lambda * (delay(p) - maxDelay), which bounds the
+ * optimal cost of the constrained problem.
+ *
+ * Costs and delays are given by functions of the edge (u, v) and must be non
+ * negative.
+ */
+template <typename G>
+class LagrangianShortestPath {
+  public:
+    using weight_type = typename G::weight_type;
+    static_assert(std::is_floating_point_v<weight_type>,
+        "cost + lambda * delay needs floating point weights");
+
+    explicit LagrangianShortestPath(const G& _graph)
+        : m_shortestPath(_graph) {}
+
+    /**
+     * \brief Search a path from _s to _t with a delay of at most _maxDelay
+     * Returns false if no path meets the delay.
+     */
+    template <typename CostFunction, typename DelayFunction>
+    bool solve(const Graph::Node _s, const Graph::Node _t,
+        const double _maxDelay, CostFunction _cost, DelayFunction _delay) {
+        return solve(_s, _t, _maxDelay, _cost, _delay,
+            [](const Graph::Node /*unused*/, const Graph::Node /*unused*/) {
+                return true;
+            });
+    }
+
+    /**
+     * \brief Same as solve, only using the edges (u, v) for which _np(u, v)
+     * is true
+     */
+    template <typename CostFunction, typename DelayFunction,
+        typename NeighborPredicate>
+    bool solve(Graph::Node _s, Graph::Node _t, double _maxDelay,
+        CostFunction _cost, DelayFunction _delay, NeighborPredicate _np);
+
+    /**
+     * \brief Best feasible path found by the last successful call to solve
+     */
+    const Graph::Path& getPath() const { return m_path; }
+
+    double getCost() const { return m_cost; }
+
+    double getDelay() const { return m_delay; }
+
+    /**
+     * \brief Best Lagrangian lower bound on the cost of the constrained
+     * shortest path
+     */
+    double getLowerBound() const { return m_lowerBound; }
+
+    /**
+     * \brief Difference between the cost of the path and the lower bound.
+     * The path is optimal if it is 0.
+     */
+    double getGap() const { return m_cost - m_lowerBound; }
+
+    /**
+     * \brief Number of Dijkstra searches of the last call to solve
+     */
+    int getNbIterations() const { return m_nbIterations; }
+
+  private:
+    /**
+     * Cost and delay of a path
+     */
+    struct PathValue {
+        double cost;
+        double delay;
+    };
+
+    template <typename CostFunction, typename DelayFunction>
+    static PathValue getValue(
+        const Graph::Path& _path, CostFunction _cost, DelayFunction _delay) {
+        PathValue value{0.0, 0.0};
+        for (std::size_t i = 1; i < _path.size(); ++i) {
+            value.cost += _cost(_path[i - 1], _path[i]);
+            value.delay += _delay(_path[i - 1], _path[i]);
+        }
+        return value;
+    }
+
+    ShortestPath<G> m_shortestPath;
+    Graph::Path m_path{};
+    Graph::Path m_cheapPath{};
+    Graph::Path m_newPath{};
+    double m_cost{0.0};
+    double m_delay{0.0};
+    double m_lowerBound{0.0};
+    int m_nbIterations{0};
+};
+
+template <typename G>
+template <typename CostFunction, typename DelayFunction,
+    typename NeighborPredicate>
+bool LagrangianShortestPath<G>::solve(const Graph::Node _s,
+    const Graph::Node _t, const double _maxDelay, CostFunction _cost,
+    DelayFunction _delay, NeighborPredicate _np) {
+    m_nbIterations = 0;
+    const auto search = [&](const double _lambda, Graph::Path& _path) {
+        ++m_nbIterations;
+        return m_shortestPath.getShortestPath(
+            _s, _t, _np,
+            [&](const Graph::Node _u, const Graph::Node _v) {
+                return _cost(_u, _v) + _lambda * _delay(_u, _v);
+            },
+            _path);
+    };
+
+    // Cheapest path, optimal if it meets the delay
+    if (!search(0.0, m_cheapPath)) {
+        m_path.clear();
+        return false;
+    }
+    auto cheap = getValue(m_cheapPath, _cost, _delay);
+    m_lowerBound = cheap.cost;
+    if (cheap.delay <= _maxDelay) {
+        m_path.swap(m_cheapPath);
+        m_cost = cheap.cost;
+        m_delay = cheap.delay;
+        return true;
+    }
+
+    // Fastest path, found by a search on the delays only
+    m_shortestPath.getShortestPath(_s, _t, _np, _delay, m_path);
+    ++m_nbIterations;
+    auto feasible = getValue(m_path, _cost, _delay);
+    if (feasible.delay > _maxDelay) {
+        m_path.clear();
+        return false;
+    }
+
+    while (true) {
+        // Multiplier for which both paths have the same aggregated weight
+        const double lambda =
+            (feasible.cost - cheap.cost) / (cheap.delay - feasible.delay);
+        search(lambda, m_newPath);
+        const auto value = getValue(m_newPath, _cost, _delay);
+        const double weight = value.cost + lambda * value.delay;
+        m_lowerBound = std::max(m_lowerBound, weight - lambda * _maxDelay);
+        const double cheapWeight = cheap.cost + lambda * cheap.delay;
+        // Relative tolerance on the aggregated weights
+        if (weight
+            >= cheapWeight - 1e-12 * std::max(1.0, std::abs(cheapWeight))) {
+            break;
+        }
+        if (value.delay <= _maxDelay) {
+            m_path.swap(m_newPath);
+            feasible = value;
+        } else {
+            m_cheapPath.swap(m_newPath);
+            cheap = value;
+        }
+    }
+    m_cost = feasible.cost;
+    m_delay = feasible.delay;
+    return true;
+}
+
+#endif
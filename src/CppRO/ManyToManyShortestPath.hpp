@@ -0,0 +1,200 @@
+#ifndef MANYTOMANYSHORTESTPATH_HPP
+#define MANYTOMANYSHORTESTPATH_HPP
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <omp.h>
+
+#include "Graph.hpp"
+#include "Matrix.hpp"
+#include "ShortestPath.hpp"
+
+/**
+ * Distance tables between a set of sources and a set of targets.
+ * Row i of the tables corresponds to the i-th source and column j to the j-th
+ * target. Unreachable pairs keep a distance of
+ * std::numeric_limits<weight_type>::max() and a first hop of -1.
+ */
+template <typename G>
+class ManyToManyShortestPath {
+  public:
+    using weight_type = typename G::weight_type;
+
+    ManyToManyShortestPath(const G& _graph, std::vector<Graph::Node> _sources,
+        std::vector<Graph::Node> _targets)
+        : m_graph(&_graph)
+        , m_sources(std::move(_sources))
+        , m_targets(std::move(_targets))
+        , m_distance(static_cast<int>(m_sources.size()),
+              static_cast<int>(m_targets.size()),
+              std::numeric_limits<weight_type>::max())
+        , m_firstHop(static_cast<int>(m_sources.size()),
+              static_cast<int>(m_targets.size()), -1) {}
+
+    ManyToManyShortestPath(const ManyToManyShortestPath&) = default;
+    ManyToManyShortestPath& operator=(const ManyToManyShortestPath&) = default;
+    ManyToManyShortestPath(ManyToManyShortestPath&&) noexcept = default;
+    ManyToManyShortestPath& operator=(
+        ManyToManyShortestPath&&) noexcept = default;
+    ~ManyToManyShortestPath() = default;
+
+    /**
+     * \brief Fill the distance table, and the first hop table if
+     * _withFirstHops is set.
+     * One shortest path tree is computed per distinct source, and the trees
+     * are spread over _nbThreads threads.
+     */
+    void computeDistances(
+        bool _withFirstHops = false, int _nbThreads = omp_get_max_threads());
+
+    /**
+     * \brief Fill the distance table using the bucket-based many-to-many
+     * algorithm on a contraction hierarchy.
+     * \param _upward The graph of the edges going up in the hierarchy
+     * \param _downwardReversed The reversed graph of the edges going down in
+     * the hierarchy
+     * The first hop table is not filled since it would require unpacking the
+     * shortcuts.
+     */
+    template <typename UpwardGraph>
+    void computeDistancesCH(const UpwardGraph& _upward,
+        const UpwardGraph& _downwardReversed,
+        int _nbThreads = omp_get_max_threads());
+
+    const Matrix<weight_type>& getDistance() const { return m_distance; }
+
+    weight_type getDistance(const int _i, const int _j) const {
+        return m_distance(_i, _j);
+    }
+
+    const Matrix<Graph::Node>& getFirstHop() const { return m_firstHop; }
+
+    Graph::Node getFirstHop(const int _i, const int _j) const {
+        return m_firstHop(_i, _j);
+    }
+
+  private:
+    /**
+     * Returns the index of the rows sorted by source, and the start of each
+     * group of rows sharing the same source.
+     */
+    std::pair<std::vector<int>, std::vector<int>> getSourceGroups() const;
+
+    G const* m_graph;
+    std::vector<Graph::Node> m_sources;
+    std::vector<Graph::Node> m_targets;
+    Matrix<weight_type> m_distance;
+    Matrix<Graph::Node> m_firstHop;
+};
+
+template <typename G>
+std::pair<std::vector<int>, std::vector<int>>
+ManyToManyShortestPath<G>::getSourceGroups() const {
+    std::vector<int> rows(m_sources.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    std::stable_sort(rows.begin(), rows.end(), [&](const int _i, const int _j) {
+        return m_sources[_i] < m_sources[_j];
+    });
+    std::vector<int> groupStarts;
+    for (int i = 0; i < static_cast<int>(rows.size()); ++i) {
+        if (i == 0 || m_sources[rows[i]] != m_sources[rows[i - 1]]) {
+            groupStarts.push_back(i);
+        }
+    }
+    groupStarts.push_back(static_cast<int>(rows.size()));
+    return {rows, groupStarts};
+}
+
+template <typename G>
+void ManyToManyShortestPath<G>::computeDistances(
+    const bool _withFirstHops, const int _nbThreads) {
+    const auto groups = getSourceGroups();
+    const auto& rows = groups.first;
+    const auto& groupStarts = groups.second;
+    const int nbGroups = static_cast<int>(groupStarts.size()) - 1;
+    const int nbTargets = static_cast<int>(m_targets.size());
+
+#pragma omp parallel num_threads(_nbThreads)
+    {
+        ShortestPath<G> shortestPath(*m_graph);
+        std::vector<Graph::Node> firstHops(
+            _withFirstHops ? m_graph->getOrder() : 0, -1);
+#pragma omp for schedule(dynamic)
+        for (int group = 0; group < nbGroups; ++group) {
+            const Graph::Node s = m_sources[rows[groupStarts[group]]];
+            shortestPath.computeShortestPathTree(s);
+            if (_withFirstHops) {
+                // Parents are settled before their children
+                for (const auto u : shortestPath.getSettledNodes()) {
+                    const auto parent = shortestPath.getParent(u);
+                    firstHops[u] = u == s || parent == s ? u
+                                                         : firstHops[parent];
+                }
+            }
+            for (int i = groupStarts[group]; i < groupStarts[group + 1]; ++i) {
+                for (int j = 0; j < nbTargets; ++j) {
+                    const auto t = m_targets[j];
+                    m_distance(rows[i], j) = shortestPath.getDistance(t);
+                    if (_withFirstHops) {
+                        m_firstHop(rows[i], j) =
+                            shortestPath.getParent(t) == -1 ? -1 : firstHops[t];
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename G>
+template <typename UpwardGraph>
+void ManyToManyShortestPath<G>::computeDistancesCH(const UpwardGraph& _upward,
+    const UpwardGraph& _downwardReversed, const int _nbThreads) {
+    m_distance.fill(std::numeric_limits<weight_type>::max());
+
+    // Backward upward searches: bucket[v] holds (target column, dist(v, t))
+    std::vector<std::vector<std::pair<int, weight_type>>> buckets(
+        _downwardReversed.getOrder());
+    {
+        ShortestPath<UpwardGraph> backwardSearch(_downwardReversed);
+        for (int j = 0; j < static_cast<int>(m_targets.size()); ++j) {
+            backwardSearch.computeShortestPathTree(m_targets[j]);
+            for (const auto v : backwardSearch.getSettledNodes()) {
+                buckets[v].emplace_back(j, backwardSearch.getDistance(v));
+            }
+        }
+    }
+
+    // Forward upward searches scan the buckets of the settled nodes
+    const auto groups = getSourceGroups();
+    const auto& rows = groups.first;
+    const auto& groupStarts = groups.second;
+    const int nbGroups = static_cast<int>(groupStarts.size()) - 1;
+#pragma omp parallel num_threads(_nbThreads)
+    {
+        ShortestPath<UpwardGraph> forwardSearch(_upward);
+#pragma omp for schedule(dynamic)
+        for (int group = 0; group < nbGroups; ++group) {
+            const int firstRow = rows[groupStarts[group]];
+            forwardSearch.computeShortestPathTree(m_sources[firstRow]);
+            for (const auto v : forwardSearch.getSettledNodes()) {
+                const auto distV = forwardSearch.getDistance(v);
+                for (const auto& [j, distT] : buckets[v]) {
+                    m_distance(firstRow, j) =
+                        std::min(m_distance(firstRow, j), distV + distT);
+                }
+            }
+            for (int i = groupStarts[group] + 1; i < groupStarts[group + 1];
+                 ++i) {
+                for (int j = 0; j < static_cast<int>(m_targets.size()); ++j) {
+                    m_distance(rows[i], j) = m_distance(firstRow, j);
+                }
+            }
+        }
+    }
+}
+
+#endif
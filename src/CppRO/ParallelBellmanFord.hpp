@@ -0,0 +1,273 @@
+#ifndef PARALLELBELLMANFORD_HPP
+#define PARALLELBELLMANFORD_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <limits>
+#include <vector>
+
+#include <omp.h>
+
+#include "Graph.hpp"
+
+/**
+ * Multithreaded single source shortest path tree for graphs with negative
+ * weights, where Dijkstra does not apply.
+ *
+ * Each round relaxes the out-edges of the frontier, the nodes whose distance
+ * decreased during the previous round. Distances are lowered with an atomic
+ * min and the improved nodes are collected in per thread buffers to form the
+ * next frontier. The parent of a node is set after the round from the
+ * relaxation that achieved its final distance, so parents and distances stay
+ * consistent.
+ *
+ * Negative cycles are searched every log(n) rounds by pointer jumping on the
+ * parent graph, which is done in parallel and amortized over the rounds, and
+ * are certain once the frontier is still non empty after n rounds.
+ */
+template <typename G>
+class ParallelBellmanFord {
+  public:
+    using weight_type = typename G::weight_type;
+
+    explicit ParallelBellmanFord(
+        const G& _graph, const int _nbThreads = omp_get_max_threads())
+        : m_graph(&_graph)
+        , m_nbThreads(_nbThreads)
+        , m_distance(_graph.getOrder(), std::numeric_limits<weight_type>::max())
+        , m_parent(_graph.getOrder(), -1)
+        , m_inNextFrontier(_graph.getOrder(), 0)
+        , m_jump(_graph.getOrder())
+        , m_nextJump(_graph.getOrder()) {}
+
+    ParallelBellmanFord(const ParallelBellmanFord&) = default;
+    ParallelBellmanFord& operator=(const ParallelBellmanFord&) = default;
+    ParallelBellmanFord(ParallelBellmanFord&&) noexcept = default;
+    ParallelBellmanFord& operator=(ParallelBellmanFord&&) noexcept = default;
+    ~ParallelBellmanFord() = default;
+
+    weight_type getDistance(const Graph::Node _u) const {
+        return m_distance[_u];
+    }
+
+    Graph::Node getParent(const Graph::Node _u) const { return m_parent[_u]; }
+
+    const std::vector<weight_type>& getDistances() const { return m_distance; }
+
+    const std::vector<Graph::Node>& getParents() const { return m_parent; }
+
+    /**
+     * \brief Compute the shortest path tree rooted at _s
+     * Returns false if a negative cycle is reachable from _s, in which case
+     * the cycle is available with getNegativeCycle and the distances are
+     * meaningless.
+     */
+    bool computeShortestPathTree(Graph::Node _s);
+
+    /**
+     * \brief Returns the negative cycle found by the last computation, as a
+     * closed path, or an empty path if there was none
+     */
+    const Graph::Path& getNegativeCycle() const { return m_negativeCycle; }
+
+    Graph::Path getShortestPath(const Graph::Node _s, const Graph::Node _t) {
+        Graph::Path path;
+        if (computeShortestPathTree(_s) && m_parent[_t] != -1) {
+            Graph::Node node = _t;
+            while (node != _s) {
+                path.push_back(node);
+                node = m_parent[node];
+            }
+            path.push_back(node);
+            std::reverse(path.begin(), path.end());
+        }
+        return path;
+    }
+
+  private:
+    struct Proposal {
+        Graph::Node node;
+        Graph::Node parent;
+        weight_type distance;
+    };
+
+    /**
+     * Lower the distance of _v to _distance if it is smaller. Returns true if
+     * it was.
+     */
+    bool atomicMin(const Graph::Node _v, const weight_type _distance) {
+        std::atomic_ref<weight_type> distance(m_distance[_v]);
+        weight_type current = distance.load(std::memory_order_relaxed);
+        while (_distance < current) {
+            if (distance.compare_exchange_weak(
+                    current, _distance, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Returns a node on a cycle of the parent graph, or -1. Must be called by
+     * all the threads of the parallel region.
+     */
+    Graph::Node findParentCycle(Graph::Node _s);
+
+    void extractCycle(Graph::Node _u);
+
+    G const* m_graph;
+    int m_nbThreads;
+    std::vector<weight_type> m_distance;
+    std::vector<Graph::Node> m_parent;
+    std::vector<char> m_inNextFrontier;
+    std::vector<Graph::Node> m_frontier{};
+    // Per thread buffers of the next frontier and of the successful
+    // relaxations of the round
+    std::vector<std::vector<Graph::Node>> m_nextFrontiers{};
+    std::vector<std::vector<Proposal>> m_proposals{};
+    // Pointer jumping buffers of findParentCycle
+    std::vector<Graph::Node> m_jump;
+    std::vector<Graph::Node> m_nextJump;
+    Graph::Node m_cycleNode{-1};
+    Graph::Path m_negativeCycle{};
+};
+
+template <typename G>
+bool ParallelBellmanFord<G>::computeShortestPathTree(const Graph::Node _s) {
+    const int order = m_graph->getOrder();
+    // Pointer jumping costs O(n log n), so it is run every log(n) rounds
+    int checkInterval = 1;
+    while ((1 << checkInterval) < order) {
+        ++checkInterval;
+    }
+    int round = 0;
+    Graph::Node cycleNode = -1;
+    m_negativeCycle.clear();
+
+#pragma omp parallel num_threads(m_nbThreads)
+    {
+        const int thread = omp_get_thread_num();
+#pragma omp single
+        {
+            const int nbThreads = omp_get_num_threads();
+            m_nextFrontiers.resize(nbThreads);
+            m_proposals.resize(nbThreads);
+            m_frontier.assign(1, _s);
+        }
+#pragma omp for
+        for (Graph::Node u = 0; u < order; ++u) {
+            m_distance[u] =
+                u == _s ? 0 : std::numeric_limits<weight_type>::max();
+            m_parent[u] = u == _s ? _s : -1;
+        }
+
+        while (!m_frontier.empty() && cycleNode == -1) {
+            auto& nextFrontier = m_nextFrontiers[thread];
+            auto& proposals = m_proposals[thread];
+#pragma omp for schedule(dynamic, 16)
+            for (std::size_t i = 0; i < m_frontier.size(); ++i) {
+                const auto u = m_frontier[i];
+                const weight_type distU =
+                    std::atomic_ref<weight_type>(m_distance[u]).load(
+                        std::memory_order_relaxed);
+                for (const auto v : m_graph->getNeighbors(u)) {
+                    const weight_type dist =
+                        distU + m_graph->getEdgeWeight(u, v);
+                    if (atomicMin(v, dist)) {
+                        proposals.push_back({v, u, dist});
+                        std::atomic_ref<char> inNextFrontier(
+                            m_inNextFrontier[v]);
+                        if (!inNextFrontier.exchange(
+                                1, std::memory_order_relaxed)) {
+                            nextFrontier.push_back(v);
+                        }
+                    }
+                }
+            }
+            // The parent of a node is one of the relaxations that reached its
+            // final distance of the round
+            for (const auto& [v, u, dist] : proposals) {
+                if (dist == m_distance[v]) {
+                    std::atomic_ref<Graph::Node>(m_parent[v]).store(
+                        u, std::memory_order_relaxed);
+                }
+            }
+            proposals.clear();
+            for (const auto v : nextFrontier) {
+                m_inNextFrontier[v] = 0;
+            }
+#pragma omp barrier
+#pragma omp single
+            {
+                ++round;
+                m_frontier.clear();
+                for (auto& frontier : m_nextFrontiers) {
+                    m_frontier.insert(
+                        m_frontier.end(), frontier.begin(), frontier.end());
+                    frontier.clear();
+                }
+            }
+            if (!m_frontier.empty()
+                && (round % checkInterval == 0 || round >= order)) {
+                const auto node = findParentCycle(_s);
+#pragma omp single
+                {
+                    cycleNode = node;
+                    // Still improving after n rounds
+                    assert(cycleNode != -1 || round < order);
+                }
+            }
+        }
+    }
+
+    if (cycleNode != -1) {
+        extractCycle(cycleNode);
+        return false;
+    }
+    return true;
+}
+
+template <typename G>
+Graph::Node ParallelBellmanFord<G>::findParentCycle(const Graph::Node _s) {
+    const int order = m_graph->getOrder();
+#pragma omp single
+    m_cycleNode = -1;
+#pragma omp for
+    for (Graph::Node u = 0; u < order; ++u) {
+        m_jump[u] = m_parent[u];
+    }
+    // After the k-th step, m_jump[u] is the 2^k-th ancestor of u
+    for (int length = 1; length < order; length *= 2) {
+#pragma omp for
+        for (Graph::Node u = 0; u < order; ++u) {
+            m_nextJump[u] = m_jump[u] == -1 ? -1 : m_jump[m_jump[u]];
+        }
+#pragma omp single
+        m_jump.swap(m_nextJump);
+    }
+    // Ancestors at distance n are on a cycle, or are the root. The source is
+    // on a cycle if its parent or distance changed.
+    const bool isSourceRoot = m_parent[_s] == _s && m_distance[_s] == 0;
+#pragma omp for
+    for (Graph::Node u = 0; u < order; ++u) {
+        const auto ancestor = m_jump[u];
+        if (ancestor != -1 && (ancestor != _s || !isSourceRoot)) {
+            std::atomic_ref<Graph::Node>(m_cycleNode).store(
+                ancestor, std::memory_order_relaxed);
+        }
+    }
+    return m_cycleNode;
+}
+
+template <typename G>
+void ParallelBellmanFord<G>::extractCycle(const Graph::Node _u) {
+    m_negativeCycle.push_back(_u);
+    for (auto node = m_parent[_u]; node != _u; node = m_parent[node]) {
+        m_negativeCycle.push_back(node);
+    }
+    m_negativeCycle.push_back(_u);
+    std::reverse(m_negativeCycle.begin(), m_negativeCycle.end());
+}
+
+#endif
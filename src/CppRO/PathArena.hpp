@@ -0,0 +1,107 @@
+#ifndef PATHARENA_HPP
+#define PATHARENA_HPP
+
+#include <cassert>
+#include <span>
+#include <vector>
+
+#include "Graph.hpp"
+
+/**
+ * Set of paths stored back to back in a single buffer.
+ * clear() keeps the memory, so an arena reused across queries stops
+ * allocating once it has grown to the largest result.
+ * Views returned by operator[] are invalidated by any insertion.
+ */
+class PathArena {
+  public:
+    using PathView = std::span<const Graph::Node>;
+
+    PathArena() = default;
+    PathArena(const PathArena&) = default;
+    PathArena& operator=(const PathArena&) = default;
+    PathArena(PathArena&&) noexcept = default;
+    PathArena& operator=(PathArena&&) noexcept = default;
+    ~PathArena() = default;
+
+    void reserve(const std::size_t _nbPaths, const std::size_t _nbNodes) {
+        m_offsets.reserve(_nbPaths + 1);
+        m_nodes.reserve(_nbNodes);
+    }
+
+    /**
+     * \brief Remove all the paths, including a path being built
+     */
+    void clear() {
+        m_nodes.clear();
+        m_offsets.resize(1);
+    }
+
+    std::size_t size() const { return m_offsets.size() - 1; }
+
+    bool empty() const { return size() == 0; }
+
+    PathView operator[](const std::size_t _i) const {
+        assert(_i < size());
+        return {m_nodes.data() + m_offsets[_i],
+            m_offsets[_i + 1] - m_offsets[_i]};
+    }
+
+    PathView back() const { return (*this)[size() - 1]; }
+
+    /**
+     * \brief Append a complete path and returns its index
+     * The range must not belong to this arena, use appendPrefix instead.
+     */
+    template <typename InputIterator>
+    std::size_t push(InputIterator _first, InputIterator _last) {
+        append(_first, _last);
+        return closePath();
+    }
+
+    /**
+     * \brief Append nodes to the path being built
+     */
+    template <typename InputIterator>
+    void append(InputIterator _first, InputIterator _last) {
+        m_nodes.insert(m_nodes.end(), _first, _last);
+    }
+
+    void append(const Graph::Node _u) { m_nodes.push_back(_u); }
+
+    /**
+     * \brief Append the first _length nodes of the path _i of this arena to
+     * the path being built
+     */
+    void appendPrefix(const std::size_t _i, const std::size_t _length) {
+        assert(_length <= (*this)[_i].size());
+        const auto first = m_offsets[_i];
+        m_nodes.reserve(m_nodes.size() + _length);
+        for (std::size_t j = 0; j < _length; ++j) {
+            m_nodes.push_back(m_nodes[first + j]);
+        }
+    }
+
+    /**
+     * \brief Terminate the path being built and returns its index
+     */
+    std::size_t closePath() {
+        m_offsets.push_back(m_nodes.size());
+        return size() - 1;
+    }
+
+    /**
+     * \brief Remove the last complete path
+     */
+    void dropLastPath() {
+        assert(!empty());
+        m_offsets.pop_back();
+        m_nodes.resize(m_offsets.back());
+    }
+
+  private:
+    std::vector<Graph::Node> m_nodes{};
+    std::vector<std::size_t> m_offsets{0};
+};
+
+#endif
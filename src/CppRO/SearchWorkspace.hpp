@@ -0,0 +1,188 @@
+#ifndef SEARCHWORKSPACE_HPP
+#define SEARCHWORKSPACE_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#include "Graph.hpp"
+
+/**
+ * Per node state of a shortest path search that can be reset in O(1).
+ * Each node carries the id of the last query that touched it. The state of a
+ * node whose stamp differs from the current query id is considered to be the
+ * initial one (infinite distance, no parent, color and count of 0), so reset()
+ * only increments the query id. The stamps are wiped when the id wraps around.
+ *
+ * \tparam W The distance type
+ * \tparam Stamp The unsigned type used for the query ids
+ */
+template <typename W, typename Stamp = std::uint32_t>
+class SearchWorkspace {
+  public:
+    struct NodeState {
+        W distance;
+        Graph::Node parent;
+        int count;
+        char color;
+    };
+
+    /**
+     * Nodes of the path from the root of the search tree to a node, read
+     * from the parent array in reverse order (from the node to the root).
+     * Invalidated by the next reset.
+     */
+    class ReversedPathView {
+      public:
+        class iterator {
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Graph::Node;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Graph::Node*;
+            using reference = const Graph::Node&;
+
+            iterator() = default;
+            iterator(const SearchWorkspace* _workspace, const Graph::Node _u)
+                : m_workspace(_workspace)
+                , m_node(_u) {}
+
+            reference operator*() const { return m_node; }
+
+            iterator& operator++() {
+                const auto parent = m_workspace->at(m_node).parent;
+                m_node = parent == m_node ? -1 : parent;
+                return *this;
+            }
+
+            iterator operator++(int) {
+                auto retval = *this;
+                ++(*this);
+                return retval;
+            }
+
+            bool operator==(const iterator& _other) const {
+                return m_node == _other.m_node;
+            }
+
+          private:
+            const SearchWorkspace* m_workspace{nullptr};
+            Graph::Node m_node{-1};
+        };
+
+        ReversedPathView(
+            const SearchWorkspace& _workspace, const Graph::Node _u)
+            : m_workspace(&_workspace)
+            , m_node(_workspace.getParent(_u) == -1 ? -1 : _u) {}
+
+        iterator begin() const { return {m_workspace, m_node}; }
+
+        iterator end() const { return {m_workspace, -1}; }
+
+        bool empty() const { return m_node == -1; }
+
+        std::size_t size() const {
+            return static_cast<std::size_t>(std::distance(begin(), end()));
+        }
+
+      private:
+        const SearchWorkspace* m_workspace;
+        Graph::Node m_node;
+    };
+
+    explicit SearchWorkspace(const int _order)
+        : m_stamps(_order, 0)
+        , m_states(_order) {}
+
+    SearchWorkspace(const SearchWorkspace&) = default;
+    SearchWorkspace& operator=(const SearchWorkspace&) = default;
+    SearchWorkspace(SearchWorkspace&&) noexcept = default;
+    SearchWorkspace& operator=(SearchWorkspace&&) noexcept = default;
+    ~SearchWorkspace() = default;
+
+    /**
+     * \brief Start a new query, resetting the state of all nodes
+     */
+    void reset() {
+        if (++m_query == 0) {
+            std::fill(m_stamps.begin(), m_stamps.end(), 0);
+            m_query = 1;
+        }
+    }
+
+    int getOrder() const { return static_cast<int>(m_states.size()); }
+
+    /**
+     * \brief Returns true if _u has been touched since the last reset
+     */
+    bool isTouched(const Graph::Node _u) const {
+        return m_stamps[_u] == m_query;
+    }
+
+    /**
+     * \brief Returns the state of _u, initializing it if _u has not been
+     * touched since the last reset
+     */
+    NodeState& operator[](const Graph::Node _u) {
+        if (m_stamps[_u] != m_query) {
+            m_stamps[_u] = m_query;
+            m_states[_u] = {std::numeric_limits<W>::max(), -1, 0, 0};
+        }
+        return m_states[_u];
+    }
+
+    /**
+     * \brief Returns the state of a node touched since the last reset
+     */
+    const NodeState& at(const Graph::Node _u) const {
+        assert(isTouched(_u));
+        return m_states[_u];
+    }
+
+    W getDistance(const Graph::Node _u) const {
+        return isTouched(_u) ? m_states[_u].distance
+                             : std::numeric_limits<W>::max();
+    }
+
+    Graph::Node getParent(const Graph::Node _u) const {
+        return isTouched(_u) ? m_states[_u].parent : -1;
+    }
+
+    char getColor(const Graph::Node _u) const {
+        return isTouched(_u) ? m_states[_u].color : 0;
+    }
+
+    int getCount(const Graph::Node _u) const {
+        return isTouched(_u) ? m_states[_u].count : 0;
+    }
+
+    /**
+     * \brief Returns the path from the root to _u, from _u backward. The view
+     * is empty if _u has no parent.
+     */
+    ReversedPathView getReversedPath(const Graph::Node _u) const {
+        return {*this, _u};
+    }
+
+    /**
+     * \brief Write the path from the root to _u into _path, without
+     * allocating if _path is large enough. Returns false and clears _path if
+     * _u has no parent.
+     */
+    bool getPath(const Graph::Node _u, Graph::Path& _path) const {
+        const auto view = getReversedPath(_u);
+        _path.resize(view.size());
+        std::copy(view.begin(), view.end(), _path.rbegin());
+        return !_path.empty();
+    }
+
+  private:
+    Stamp m_query{1};
+    std::vector<Stamp> m_stamps;
+    std::vector<NodeState> m_states;
+};
+
+#endif
@@ -1,30 +1,38 @@
 #ifndef SHORTESTPATH_HPP
 #define SHORTESTPATH_HPP
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+#include <omp.h>
 
 #include "BinaryHeap.hpp"
 #include "Graph.hpp"
+#include "PathArena.hpp"
+#include "SearchWorkspace.hpp"
 #include "utility.hpp"
 
 template <typename G,
     typename DistanceComparator = std::less<typename G::weight_type>>
 class ShortestPath {
+    using Heap = BinaryHeap<Graph::Node,
+        std::function<bool(const Graph::Node, const Graph::Node)>>;
+
   public:
     using weight_type = typename G::weight_type;
     explicit ShortestPath(
         const G& _graph, DistanceComparator _distComp = DistanceComparator())
         : m_graph(&_graph)
         , m_distComp(_distComp)
-        , m_distance(_graph.getOrder(), std::numeric_limits<weight_type>::max())
-        , m_parent(_graph.getOrder(), -1)
-        , m_color(_graph.getOrder(), 0)
+        , m_workspace(_graph.getOrder())
         , m_handles(_graph.getOrder())
-        , m_heap(_graph.getOrder(),
-              [&](const Graph::Node _u, const Graph::Node _v) {
-                  return m_distComp(m_distance[_u], m_distance[_v]);
-              }) {}
+        , m_heap(_graph.getOrder(), getHeapComparator()) {
+        m_settled.reserve(_graph.getOrder());
+    }
     // Copy
     ShortestPath(const ShortestPath& _other)
         : ShortestPath(*_other.m_graph) {}
@@ -32,20 +40,11 @@ class ShortestPath {
     ShortestPath& operator=(const ShortestPath& _other) {
         if (this != &_other) {
             m_graph = _other.m_graph;
-            m_distance = std::vector<weight_type>(
-                m_graph->getOrder(), std::numeric_limits<weight_type>::max());
-            m_parent = std::vector<int>(m_graph->getOrder(), -1);
-            m_color = std::vector<char>(m_graph->getOrder(), 0);
-            m_handles = std::vector<
-                typename BinaryHeap<int, std::function<bool(const Graph::Node,
-                                             const Graph::Node)>>::Handle*>(
-                m_graph->getOrder());
-            m_heap = BinaryHeap<int,
-                std::function<bool(const Graph::Node, const Graph::Node)>>(
-                m_graph->getOrder(),
-                [&](const Graph::Node _u, const Graph::Node _v) {
-                    return m_distComp(m_distance[_u], m_distance[_v]);
-                });
+            m_workspace = SearchWorkspace<weight_type>(m_graph->getOrder());
+            m_settled.clear();
+            m_handles =
+                std::vector<typename Heap::Handle*>(m_graph->getOrder());
+            m_heap = Heap(m_graph->getOrder(), getHeapComparator());
         }
         return *this;
     }
@@ -53,31 +52,19 @@ class ShortestPath {
     // Move
     ShortestPath(ShortestPath&& _other) noexcept
         : m_graph(std::move(_other.m_graph))
-        , m_distance(std::move(_other.m_distance))
-        , m_parent(std::move(_other.m_parent))
-        , m_color(std::move(_other.m_color))
+        , m_workspace(std::move(_other.m_workspace))
+        , m_settled(std::move(_other.m_settled))
         , m_handles(m_graph->getOrder())
-        , m_heap(m_graph->getOrder(),
-              [&](const Graph::Node _u, const Graph::Node _v) {
-                  return m_distComp(m_distance[_u], m_distance[_v]);
-              }) {}
+        , m_heap(m_graph->getOrder(), getHeapComparator()) {}
 
     ShortestPath& operator=(ShortestPath&& _other) noexcept {
         if (this != &_other) {
             m_graph = std::move(_other.m_graph);
-            m_distance = std::move(_other.m_distance);
-            m_parent = std::move(_other.m_parent);
-            m_color = std::move(_other.m_color);
-            m_handles = std::vector<
-                typename BinaryHeap<int, std::function<bool(const Graph::Node,
-                                             const Graph::Node)>>::Handle*>(
-                m_graph->getOrder());
-            m_heap = BinaryHeap<int,
-                std::function<bool(const Graph::Node, const Graph::Node)>>(
-                m_graph->getOrder(),
-                [&](const Graph::Node _u, const Graph::Node _v) {
-                    return m_distComp(m_distance[_u], m_distance[_v]);
-                });
+            m_workspace = std::move(_other.m_workspace);
+            m_settled = std::move(_other.m_settled);
+            m_handles =
+                std::vector<typename Heap::Handle*>(m_graph->getOrder());
+            m_heap = Heap(m_graph->getOrder(), getHeapComparator());
         }
         return *this;
     }
@@ -85,286 +72,619 @@ class ShortestPath {
     ~ShortestPath() = default;
 
     weight_type getDistance(const Graph::Node _u) const {
-        return m_distance[_u];
+        return m_workspace.getDistance(_u);
     }
 
+    Graph::Node getParent(const Graph::Node _u) const {
+        return m_workspace.getParent(_u);
+    }
+
+    /**
+     * \brief Returns the nodes settled by the last search, in settling order
+     */
+    const std::vector<Graph::Node>& getSettledNodes() const {
+        return m_settled;
+    }
+
+    /**
+     * \brief Reset the search state. Only costs O(1) thanks to the workspace
+     * stamps.
+     */
     void clear() {
-        std::fill(m_parent.begin(), m_parent.end(), -1);
-        std::fill(m_distance.begin(), m_distance.end(),
-            std::numeric_limits<weight_type>::max());
-        std::fill(m_color.begin(), m_color.end(), 0);
+        m_workspace.reset();
         m_heap.clear();
+        m_settled.clear();
+    }
+
+    /**
+     * \brief Compute the shortest path tree rooted at _s
+     * The distance and parent of every node reachable from _s are then
+     * available with getDistance and getParent.
+     */
+    void computeShortestPathTree(const Graph::Node _s) {
+        search(_s, -1, AllNeighbors{}, EdgeWeight{m_graph});
+    }
+
+    /**
+     * \brief Compute the shortest path tree rooted at _s for the weights given
+     * by _wf(u, v), which must be non negative
+     */
+    template <typename WeightFunction>
+    void computeShortestPathTree(const Graph::Node _s, WeightFunction _wf) {
+        search(_s, -1, AllNeighbors{}, _wf);
+    }
+
+    /**
+     * \brief Settle the nodes at a distance of at most _bound from _s
+     * The search stops once the closest node left is farther than _bound, so
+     * its cost only depends on the explored region. Only the settled nodes,
+     * given by getSettledNodes, have their final distance and parent.
+     */
+    void computeShortestPathTreeWithin(
+        const Graph::Node _s, const weight_type _bound) {
+        computeShortestPathTreeWithin(_s, _bound, EdgeWeight{m_graph});
+    }
+
+    template <typename WeightFunction>
+    void computeShortestPathTreeWithin(
+        const Graph::Node _s, const weight_type _bound, WeightFunction _wf) {
+        search(_s, AllNeighbors{}, _wf, [&](const Graph::Node _u) {
+            return m_distComp(_bound, m_workspace.at(_u).distance)
+                       ? Settle::StopBefore
+                       : Settle::Continue;
+        });
+    }
+
+    /**
+     * \brief Search from _s until every node of _targets is settled, or
+     * until the closest node left is farther than _bound
+     * Only the settled nodes, given by getSettledNodes, have their final
+     * distance and parent. Returns the number of distinct targets settled.
+     */
+    int computeShortestPathsToTargets(const Graph::Node _s,
+        const std::vector<Graph::Node>& _targets,
+        const weight_type _bound = std::numeric_limits<weight_type>::max()) {
+        return computeShortestPathsToTargets(
+            _s, _targets, _bound, EdgeWeight{m_graph});
+    }
+
+    template <typename WeightFunction>
+    int computeShortestPathsToTargets(const Graph::Node _s,
+        const std::vector<Graph::Node>& _targets, weight_type _bound,
+        WeightFunction _wf);
+
+    /**
+     * \brief Returns true if _u was settled by the last search
+     */
+    bool isSettled(const Graph::Node _u) const {
+        return m_workspace.getColor(_u) == 2;
     }
 
     Graph::Path getShortestPath(const Graph::Node _s, const Graph::Node _t) {
-        clear();
-        m_parent[_s] = _s;
-        m_distance[_s] = 0;
-        m_handles[_s] = m_heap.push(_s);
-        m_color[_s] = 1;
+        return getShortestPath(_s, _t, AllNeighbors{}, EdgeWeight{m_graph});
+    }
+
+    /**
+     * \brief Write the shortest path from _s to _t into _path
+     * _path keeps its capacity, so reusing the same buffer across queries
+     * does not allocate. Returns false, with an empty _path, if _t is not
+     * reachable.
+     */
+    bool getShortestPath(
+        const Graph::Node _s, const Graph::Node _t, Graph::Path& _path) {
+        return getShortestPath(
+            _s, _t, AllNeighbors{}, EdgeWeight{m_graph}, _path);
+    }
 
+    Graph::Path getShortestPathNbArcs(
+        const Graph::Node _s, const Graph::Node _t) {
+        return getShortestPath(_s, _t, AllNeighbors{}, NbArcs{});
+    }
+
+    bool getShortestPathNbArcs(
+        const Graph::Node _s, const Graph::Node _t, Graph::Path& _path) {
+        return getShortestPath(_s, _t, AllNeighbors{}, NbArcs{}, _path);
+    }
+
+    template <typename NeighborPredicate, typename WeightFunction>
+    Graph::Path getShortestPath(const Graph::Node _s, const Graph::Node _t,
+        NeighborPredicate _np, WeightFunction _wf) {
         Graph::Path path;
-        while (_t != m_heap.top()) {
-            if (m_heap.empty()) {
-                return {};
-            }
-            const auto u = m_heap.top();
-            m_heap.pop();
-            m_color[u] = 2;
+        getShortestPath(_s, _t, _np, _wf, path);
+        return path;
+    }
 
-            for (const auto& v : m_graph->getNeighbors(u)) {
-                if (m_color[v] != 2) {
-                    auto distT = m_distance[u] + m_graph->getEdgeWeight(u, v);
-                    if (m_distComp(distT, m_distance[v])) {
-                        m_distance[v] = distT;
-                        if (m_color[v] == 1) {
-                            m_heap.decrease(m_handles[v]);
-                        } else {
-                            m_handles[v] = m_heap.push(v);
-                            m_color[v] = 1;
-                        }
-                        m_parent[v] = u;
-                    }
-                }
-            }
+    template <typename NeighborPredicate, typename WeightFunction>
+    bool getShortestPath(const Graph::Node _s, const Graph::Node _t,
+        NeighborPredicate _np, WeightFunction _wf, Graph::Path& _path) {
+        if (!search(_s, _t, _np, _wf)) {
+            _path.clear();
+            return false;
         }
+        return m_workspace.getPath(_t, _path);
+    }
+
+    template <typename NeighborPredicate>
+    Graph::Path getShortestPathNbArcs(
+        const Graph::Node _s, const Graph::Node _t, NeighborPredicate _np) {
+        return getShortestPath(_s, _t, _np, NbArcs{});
+    }
 
-        /* Path is found, need to build it */
-        Graph::Node node = _t;
-        while (node != _s) {
-            path.push_back(node);
-            node = m_parent[node];
+    /**
+     * \brief Returns the path from the source of the last search to _t,
+     * read backward from the parent array without copy
+     * The view is invalidated by the next search.
+     */
+    typename SearchWorkspace<weight_type>::ReversedPathView getReversedPath(
+        const Graph::Node _t) const {
+        return m_workspace.getReversedPath(_t);
+    }
+
+    std::vector<Graph::Path> getKShortestPath(
+        const Graph::Node _u, const Graph::Node _v, const int _k) {
+        PathArena arena;
+        getKShortestPath(_u, _v, _k, arena);
+        std::vector<Graph::Path> paths;
+        paths.reserve(arena.size());
+        for (std::size_t i = 0; i < arena.size(); ++i) {
+            paths.emplace_back(arena[i].begin(), arena[i].end());
         }
-        path.push_back(node);
-        std::reverse(path.begin(), path.end());
-        return path;
+        return paths;
     }
 
-    Graph::Path getShortestPathNbArcs(
-        const Graph::Node _s, const Graph::Node _t) {
-        clear();
-        m_parent[_s] = _s;
-        m_distance[_s] = 0;
-        m_handles[_s] = m_heap.push(_s);
-        m_color[_s] = 1;
+    /**
+     * \brief Write up to _k shortest simple paths (in number of arcs) from _u
+     * to _v into _paths
+     * Reusing the same arena across calls avoids allocating the result paths.
+     */
+    void getKShortestPath(const Graph::Node _u, const Graph::Node _v,
+        const int _k, PathArena& _paths) {
+        std::vector<weight_type> costs;
+        getKShortestPath(_u, _v, _k, _paths, costs, NbArcs{});
+    }
 
-        Graph::Path path;
-        while (_t != m_heap.top()) {
-            if (m_heap.empty()) {
-                return path;
-            }
-            const auto u = m_heap.top();
-            m_heap.pop();
-            m_color[u] = 2;
+    /**
+     * \brief Write up to _k shortest simple paths from _u to _v into _paths,
+     * and their weight into _costs
+     */
+    void getKShortestPath(const Graph::Node _u, const Graph::Node _v,
+        const int _k, PathArena& _paths, std::vector<weight_type>& _costs) {
+        getKShortestPath(_u, _v, _k, _paths, _costs, EdgeWeight{m_graph});
+    }
 
-            for (const auto& v : m_graph->getNeighbors(u)) {
-                if (m_color[v] != 2) {
-                    auto distT = m_distance[u] + 1;
-                    if (m_distComp(distT, m_distance[v])) {
-                        m_distance[v] = distT;
-                        if (m_color[v] == 1) {
-                            m_heap.decrease(m_handles[v]);
-                        } else {
-                            m_handles[v] = m_heap.push(v);
-                            m_color[v] = 1;
-                        }
-                        m_parent[v] = u;
-                    }
+    /**
+     * \brief Write up to _k shortest simple paths from _u to _v into _paths,
+     * by increasing weight according to _wf, using Yen's algorithm
+     * Candidates are kept in a heap and deduplicated by hashing. Spur searches
+     * reuse this object's workspace on a masked view of the graph, and, as
+     * proposed by Lawler, only start from the nodes at or after the deviation
+     * node of the last accepted path since the earlier ones were already
+     * examined with its parent path.
+     */
+    template <typename WeightFunction>
+    void getKShortestPath(const Graph::Node _u, const Graph::Node _v,
+        const int _k, PathArena& _paths, std::vector<weight_type>& _costs,
+        WeightFunction _wf) {
+        _paths.clear();
+        _costs.clear();
+        if (_k <= 0) {
+            return;
+        }
+        Graph::Path spurPath;
+        if (!getShortestPath(_u, _v, AllNeighbors{}, _wf, spurPath)) {
+            return;
+        }
+
+        KShortestPathCandidates candidates(m_distComp);
+        candidates.add(spurPath.begin(), spurPath.end(),
+            m_workspace.getDistance(_v), 0);
+        SpurMask mask(m_graph->getOrder());
+        std::vector<weight_type> rootCosts;
+        while (static_cast<int>(_paths.size()) < _k && !candidates.empty()) {
+            const auto [lastCost, deviation] = candidates.pop(_paths);
+            _costs.push_back(lastCost);
+            if (static_cast<int>(_paths.size()) == _k) {
+                break;
+            }
+            const auto lastPath = _paths.back();
+            computeRootCosts(lastPath, _wf, rootCosts);
+            for (std::size_t i = deviation; i + 1 < lastPath.size(); ++i) {
+                if (getSpurPath(_paths, i, mask, _v, _wf, spurPath)) {
+                    candidates.add(lastPath.begin(), lastPath.begin() + i,
+                        spurPath.begin(), spurPath.end(),
+                        rootCosts[i] + m_workspace.getDistance(_v), i);
                 }
             }
         }
+    }
 
-        /* Path is found, need to build it */
-        Graph::Node node = _t;
-        while (node != _s) {
-            path.push_back(node);
-            node = m_parent[node];
-        }
-        path.push_back(node);
-        std::reverse(path.begin(), path.end());
-        return path;
+    /**
+     * \brief Same as getKShortestPath, with the spur searches of each
+     * iteration spread over _nbThreads threads
+     * Each thread owns a search engine and a mask. The spur paths are merged
+     * in the order of their spur node, so the result does not depend on the
+     * number of threads.
+     */
+    void getKShortestPathParallel(const Graph::Node _u, const Graph::Node _v,
+        const int _k, PathArena& _paths, std::vector<weight_type>& _costs,
+        const int _nbThreads = omp_get_max_threads()) {
+        getKShortestPathParallel(
+            _u, _v, _k, _paths, _costs, EdgeWeight{m_graph}, _nbThreads);
     }
 
-    template <typename NeighborPredicate, typename WeightFunction>
-    Graph::Path getShortestPath(const Graph::Node _s, const Graph::Node _t,
-        NeighborPredicate _np, WeightFunction _wf) {
-        clear();
-        m_parent[_s] = _s;
-        m_distance[_s] = 0;
-        m_handles[_s] = m_heap.push(_s);
-        m_color[_s] = 1;
+    template <typename WeightFunction>
+    void getKShortestPathParallel(const Graph::Node _u, const Graph::Node _v,
+        const int _k, PathArena& _paths, std::vector<weight_type>& _costs,
+        WeightFunction _wf, int _nbThreads = omp_get_max_threads());
 
-        Graph::Path path;
-        while (_t != m_heap.top()) {
-            if (m_heap.empty()) {
-                return {};
+  private:
+    struct AllNeighbors {
+        bool operator()(
+            const Graph::Node /*unused*/, const Graph::Node /*unused*/) const {
+            return true;
+        }
+    };
+
+    struct EdgeWeight {
+        G const* graph;
+        weight_type operator()(
+            const Graph::Node _u, const Graph::Node _v) const {
+            return graph->getEdgeWeight(_u, _v);
+        }
+    };
+
+    struct NbArcs {
+        weight_type operator()(
+            const Graph::Node /*unused*/, const Graph::Node /*unused*/) const {
+            return 1;
+        }
+    };
+
+    /**
+     * Candidate paths of Yen's algorithm, stored in an arena, ordered by a
+     * heap on (cost, insertion order) and deduplicated by hashing.
+     */
+    class KShortestPathCandidates {
+      public:
+        explicit KShortestPathCandidates(DistanceComparator _distComp)
+            : m_distComp(std::move(_distComp)) {}
+
+        bool empty() const { return m_heap.empty(); }
+
+        /**
+         * Add the path made of [_rootFirst, _rootLast) followed by
+         * [_spurFirst, _spurLast), unless it was already added.
+         */
+        template <typename RootIterator, typename SpurIterator>
+        void add(RootIterator _rootFirst, RootIterator _rootLast,
+            SpurIterator _spurFirst, SpurIterator _spurLast,
+            const weight_type _cost, const std::size_t _deviation) {
+            m_paths.append(_rootFirst, _rootLast);
+            m_paths.append(_spurFirst, _spurLast);
+            const auto index = m_paths.closePath();
+            const auto path = m_paths[index];
+            std::size_t hash = path.size();
+            for (const auto u : path) {
+                hash ^= std::hash<Graph::Node>{}(u) + 0x9e3779b9 + (hash << 6)
+                        + (hash >> 2);
             }
-            const auto u = m_heap.top();
-            m_heap.pop();
-            m_color[u] = 2;
+            const auto [first, last] = m_hashes.equal_range(hash);
+            for (auto ite = first; ite != last; ++ite) {
+                const auto other = m_paths[ite->second];
+                if (std::equal(
+                        path.begin(), path.end(), other.begin(), other.end())) {
+                    m_paths.dropLastPath();
+                    return;
+                }
+            }
+            m_hashes.emplace(hash, index);
+            m_heap.push_back({_cost, index, _deviation});
+            std::push_heap(m_heap.begin(), m_heap.end(), getComparator());
+        }
 
-            for (const auto& v : m_graph->getNeighbors(u)) {
-                if (m_color[v] != 2 && _np(u, v)) {
-                    auto distT = m_distance[u] + _wf(u, v);
-                    if (m_distComp(distT, m_distance[v])) {
-                        m_distance[v] = distT;
-                        if (m_color[v] == 1) {
-                            m_heap.decrease(m_handles[v]);
-                        } else {
-                            m_handles[v] = m_heap.push(v);
-                            m_color[v] = 1;
-                        }
-                        m_parent[v] = u;
-                    }
+        template <typename Iterator>
+        void add(Iterator _first, Iterator _last, const weight_type _cost,
+            const std::size_t _deviation) {
+            add(_first, _last, _last, _last, _cost, _deviation);
+        }
+
+        /**
+         * Move the best candidate to _paths and returns its cost and
+         * deviation index
+         */
+        std::pair<weight_type, std::size_t> pop(PathArena& _paths) {
+            std::pop_heap(m_heap.begin(), m_heap.end(), getComparator());
+            const auto best = m_heap.back();
+            m_heap.pop_back();
+            const auto path = m_paths[best.index];
+            _paths.push(path.begin(), path.end());
+            return {best.cost, best.deviation};
+        }
+
+      private:
+        struct Candidate {
+            weight_type cost;
+            std::size_t index;
+            std::size_t deviation;
+        };
+
+        auto getComparator() const {
+            return [this](const Candidate& _c1, const Candidate& _c2) {
+                if (m_distComp(_c1.cost, _c2.cost)) {
+                    return false;
+                }
+                if (m_distComp(_c2.cost, _c1.cost)) {
+                    return true;
                 }
+                return _c1.index > _c2.index;
+            };
+        }
+
+        DistanceComparator m_distComp;
+        PathArena m_paths{};
+        std::vector<Candidate> m_heap{};
+        std::unordered_multimap<std::size_t, std::size_t> m_hashes{};
+    };
+
+    /**
+     * Nodes and edges removed from the graph during a spur search
+     */
+    struct SpurMask {
+        explicit SpurMask(const int _order)
+            : blockedNodes(_order, 0) {}
+        std::vector<char> blockedNodes;
+        std::vector<Graph::Node> blockedNextNodes{};
+    };
+
+    /**
+     * _rootCosts[i] is the weight of the first i edges of _path
+     */
+    template <typename WeightFunction>
+    static void computeRootCosts(PathArena::PathView _path, WeightFunction& _wf,
+        std::vector<weight_type>& _rootCosts) {
+        _rootCosts.resize(_path.size());
+        _rootCosts[0] = 0;
+        for (std::size_t i = 1; i < _path.size(); ++i) {
+            _rootCosts[i] = _rootCosts[i - 1] + _wf(_path[i - 1], _path[i]);
+        }
+    }
+
+    /**
+     * Spur search of Yen's algorithm from the _i-th node of the last accepted
+     * path. The nodes before the spur node are removed, as well as the edges
+     * leaving the spur node along the accepted paths sharing the same root.
+     * Returns false if there is no spur path.
+     */
+    template <typename WeightFunction>
+    bool getSpurPath(const PathArena& _accepted, const std::size_t _i,
+        SpurMask& _mask, const Graph::Node _t, WeightFunction& _wf,
+        Graph::Path& _spurPath) {
+        const auto lastPath = _accepted.back();
+        const auto spurNode = lastPath[_i];
+        for (std::size_t j = 0; j < _i; ++j) {
+            _mask.blockedNodes[lastPath[j]] = 1;
+        }
+        _mask.blockedNextNodes.clear();
+        for (std::size_t j = 0; j < _accepted.size(); ++j) {
+            const auto path = _accepted[j];
+            if (path.size() > _i + 1
+                && std::equal(lastPath.begin(), lastPath.begin() + _i + 1,
+                    path.begin())) {
+                _mask.blockedNextNodes.push_back(path[_i + 1]);
             }
         }
-        /* Path is found, need to build it */
-        Graph::Node node = _t;
-        while (node != _s) {
-            path.push_back(node);
-            node = m_parent[node];
+        const bool found = getShortestPath(
+            spurNode, _t,
+            [&](const Graph::Node _u, const Graph::Node _v) {
+                return !_mask.blockedNodes[_v]
+                       && (_u != spurNode
+                           || std::find(_mask.blockedNextNodes.begin(),
+                                  _mask.blockedNextNodes.end(), _v)
+                                  == _mask.blockedNextNodes.end());
+            },
+            _wf, _spurPath);
+        for (std::size_t j = 0; j < _i; ++j) {
+            _mask.blockedNodes[lastPath[j]] = 0;
         }
-        path.push_back(node);
-        std::reverse(path.begin(), path.end());
-        return path;
+        return found;
     }
 
-    template <typename NeighborPredicate>
-    Graph::Path getShortestPathNbArcs(
-        const Graph::Node _s, const Graph::Node _t, NeighborPredicate _np) {
-        clear();
+    std::function<bool(const Graph::Node, const Graph::Node)>
+    getHeapComparator() {
+        return [this](const Graph::Node _u, const Graph::Node _v) {
+            return m_distComp(
+                m_workspace.at(_u).distance, m_workspace.at(_v).distance);
+        };
+    }
+
+    /**
+     * What a search does with the node about to be settled
+     */
+    enum class Settle { Continue, StopBefore, StopAfter };
 
-        m_parent[_s] = _s;
-        m_distance[_s] = 0;
+    /**
+     * Dijkstra from _s, stopping once _t is settled (_t = -1 computes the whole
+     * tree). Returns true if _t was reached.
+     */
+    template <typename NeighborPredicate, typename WeightFunction>
+    bool search(const Graph::Node _s, const Graph::Node _t,
+        NeighborPredicate _np, WeightFunction _wf) {
+        return search(_s, _np, _wf, [&](const Graph::Node _u) {
+            return _u == _t ? Settle::StopAfter : Settle::Continue;
+        });
+    }
+
+    /**
+     * Dijkstra from _s, asking _settle(u) what to do before settling each
+     * node u. Returns true if the search was stopped after settling a node.
+     */
+    template <typename NeighborPredicate, typename WeightFunction,
+        typename SettleFunction>
+    bool search(const Graph::Node _s, NeighborPredicate _np,
+        WeightFunction _wf, SettleFunction _settle) {
+        clear();
+        auto& source = m_workspace[_s];
+        source.parent = _s;
+        source.distance = 0;
+        source.color = 1;
         m_handles[_s] = m_heap.push(_s);
-        m_color[_s] = 1;
 
-        Graph::Path path;
-        while (_t != m_heap.top()) {
-            if (m_heap.empty()) {
-                return path;
-            }
+        while (!m_heap.empty()) {
             const auto u = m_heap.top();
+            const auto action = _settle(u);
+            if (action == Settle::StopBefore) {
+                return false;
+            }
+            auto& stateU = m_workspace[u];
+            stateU.color = 2;
+            m_settled.push_back(u);
+            if (action == Settle::StopAfter) {
+                return true;
+            }
             m_heap.pop();
-            m_color[u] = 2;
-            for (auto& v : m_graph->getNeighbors(u)) {
-                if (m_color[v] != 2 && _np(u, v)) {
-                    auto distT = m_distance[u] + 1;
-                    if (m_distComp(distT, m_distance[v])) {
-                        m_distance[v] = distT;
-                        if (m_color[v] == 1) {
+
+            for (const auto& v : m_graph->getNeighbors(u)) {
+                auto& stateV = m_workspace[v];
+                if (stateV.color != 2 && _np(u, v)) {
+                    auto distT = stateU.distance + _wf(u, v);
+                    if (m_distComp(distT, stateV.distance)) {
+                        stateV.distance = distT;
+                        if (stateV.color == 1) {
                             m_heap.decrease(m_handles[v]);
                         } else {
                             m_handles[v] = m_heap.push(v);
-                            m_color[v] = 1;
+                            stateV.color = 1;
                         }
-                        m_parent[v] = u;
+                        stateV.parent = u;
                     }
                 }
             }
         }
-
-        /* Path is found, need to build it */
-        Graph::Node node = _t;
-        while (node != _s) {
-            path.push_back(node);
-            node = m_parent[node];
-        }
-        path.push_back(node);
-        std::reverse(path.begin(), path.end());
-        return path;
+        return false;
     }
 
-    std::vector<Graph::Path> getKShortestPath(
-        const Graph::Node _u, const Graph::Node _v, const int _k) {
-        std::vector<Graph::Path> paths;
-        if (_k == 0) {
-            return paths;
+    G const* m_graph;
+    DistanceComparator m_distComp;
+    SearchWorkspace<weight_type> m_workspace;
+    std::vector<Graph::Node> m_settled{};
+    std::vector<typename Heap::Handle*> m_handles;
+    Heap m_heap;
+    std::vector<char> m_isTarget{};
+};
+
+template <typename G, typename DistanceComparator>
+template <typename WeightFunction>
+int ShortestPath<G, DistanceComparator>::computeShortestPathsToTargets(
+    const Graph::Node _s, const std::vector<Graph::Node>& _targets,
+    const weight_type _bound, WeightFunction _wf) {
+    m_isTarget.resize(m_graph->getOrder(), 0);
+    int nbTargets = 0;
+    for (const auto t : _targets) {
+        if (!m_isTarget[t]) {
+            m_isTarget[t] = 1;
+            ++nbTargets;
         }
+    }
+    int nbLeft = nbTargets;
+    if (nbLeft > 0) {
+        search(_s, AllNeighbors{}, _wf, [&](const Graph::Node _u) {
+            if (m_distComp(_bound, m_workspace.at(_u).distance)) {
+                return Settle::StopBefore;
+            }
+            if (m_isTarget[_u] && --nbLeft == 0) {
+                return Settle::StopAfter;
+            }
+            return Settle::Continue;
+        });
+    } else {
+        clear();
+    }
+    for (const auto t : _targets) {
+        m_isTarget[t] = 0;
+    }
+    return nbTargets - nbLeft;
+}
+
+template <typename G, typename DistanceComparator>
+template <typename WeightFunction>
+void ShortestPath<G, DistanceComparator>::getKShortestPathParallel(
+    const Graph::Node _u, const Graph::Node _v, const int _k,
+    PathArena& _paths, std::vector<weight_type>& _costs, WeightFunction _wf,
+    const int _nbThreads) {
+    _paths.clear();
+    _costs.clear();
+    if (_k <= 0) {
+        return;
+    }
+    Graph::Path firstPath;
+    if (!getShortestPath(_u, _v, AllNeighbors{}, _wf, firstPath)) {
+        return;
+    }
 
-        // Determine the shortest path from the source to the sink.
-        paths.push_back(this->getShortestPathNbArcs(_u, _v));
-        // Initialize the heap to store the potential kth shortest path.
-        std::list<Graph::Path> stack;
-        for (int k = 1; k < _k; ++k) {
-            auto& lastPath = paths[k - 1];
-            auto ite = lastPath.begin();
-            for (int i = 0; i < lastPath.size() - 1; ++i, ++ite) {
-                // Spur node is retrieved from the previous k-shortest path, k
-                // − 1.
-                Graph::Node spurNode = *ite;
-                // The sequence of nodes from the source to the spur node of the
-                // previous k-shortest path.
-                Graph::Path rootPath{lastPath.begin(), std::next(ite)};
-                assert(rootPath.back() == spurNode);
-
-                G graphCopy = m_graph;
-
-                for (int j = 0; j < k; ++j) {
-                    auto p = paths[j];
-                    bool same = true;
-                    auto ite2 = p.begin();
-                    for (auto ite1 = rootPath.begin(); ite1 != rootPath.end();
-                         ++ite1, ++ite2) {
-                        if (*ite1 != *ite2) {
-                            same = false;
-                            break;
-                        }
-                    }
-                    if (same) {
-                        // Remove the links that are part of the previous
-                        // shortest paths which share the same root path.
-                        graphCopy.removeEdge(*std::prev(ite2), *ite2);
+    KShortestPathCandidates candidates(m_distComp);
+    candidates.add(
+        firstPath.begin(), firstPath.end(), m_workspace.getDistance(_v), 0);
+    std::vector<weight_type> rootCosts;
+    // Spur results of the current iteration, indexed by spur node - deviation
+    std::vector<Graph::Path> spurPaths;
+    std::vector<weight_type> spurCosts;
+    std::vector<char> found;
+    std::size_t deviation = 0;
+    std::size_t nbSpurs = 0;
+    bool done = false;
+
+#pragma omp parallel num_threads(_nbThreads)
+    {
+        ShortestPath engine(*m_graph, m_distComp);
+        SpurMask mask(m_graph->getOrder());
+        WeightFunction wf = _wf;
+        while (true) {
+#pragma omp single
+            {
+                done = static_cast<int>(_paths.size()) == _k
+                       || candidates.empty();
+                if (!done) {
+                    const auto [lastCost, lastDeviation] =
+                        candidates.pop(_paths);
+                    _costs.push_back(lastCost);
+                    done = static_cast<int>(_paths.size()) == _k;
+                    const auto lastPath = _paths.back();
+                    computeRootCosts(lastPath, wf, rootCosts);
+                    deviation = lastDeviation;
+                    nbSpurs = lastPath.size() - 1 - deviation;
+                    if (spurPaths.size() < nbSpurs) {
+                        spurPaths.resize(nbSpurs);
                     }
+                    spurCosts.resize(nbSpurs);
+                    found.resize(nbSpurs);
                 }
-
-                for (const auto& u : rootPath) {
-                    if (u != spurNode) {
-                        graphCopy.isolate(u);
-                    }
+            }
+            if (done) {
+                break;
+            }
+#pragma omp for schedule(dynamic)
+            for (std::size_t j = 0; j < nbSpurs; ++j) {
+                const auto i = deviation + j;
+                found[j] = engine.getSpurPath(
+                    _paths, i, mask, _v, wf, spurPaths[j]);
+                if (found[j]) {
+                    spurCosts[j] = rootCosts[i] + engine.getDistance(_v);
                 }
-                // Calculate the spur path from the spur node to the sink.
-                Graph::Path spurPath =
-                    ShortestPath<G>(graphCopy).getShortestPathNbArcs(
-                        spurNode, _v);
-                if (!spurPath.empty()) {
-                    assert(spurPath.front() == spurNode);
-                    rootPath.insert(rootPath.end(), std::next(spurPath.begin()),
-                        spurPath.end());
-
-                    // Search first longer path
-                    auto iteStack = stack.begin();
-                    for (; iteStack != stack.end(); ++iteStack) {
-                        if (iteStack->size() >= rootPath.size()) {
-                            break;
-                        }
+            }
+#pragma omp single
+            {
+                const auto lastPath = _paths.back();
+                for (std::size_t j = 0; j < nbSpurs; ++j) {
+                    if (found[j]) {
+                        const auto i = deviation + j;
+                        candidates.add(lastPath.begin(), lastPath.begin() + i,
+                            spurPaths[j].begin(), spurPaths[j].end(),
+                            spurCosts[j], i);
                     }
-                    stack.insert(iteStack, rootPath);
                 }
             }
-            if (stack.empty()) {
-                return paths;
-            }
-
-            paths.push_back(stack.front());
-            stack.pop_front();
         }
-        return paths;
     }
-
-  private:
-    G const* m_graph;
-    DistanceComparator m_distComp;
-    std::vector<weight_type> m_distance;
-    std::vector<Graph::Node> m_parent;
-    std::vector<char> m_color;
-    std::vector<typename BinaryHeap<Graph::Node,
-        std::function<bool(const Graph::Node, const Graph::Node)>>::Handle*>
-        m_handles;
-    BinaryHeap<Graph::Node,
-        std::function<bool(const Graph::Node, const Graph::Node)>>
-        m_heap;
-};
+}
 
 #endif
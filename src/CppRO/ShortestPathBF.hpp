@@ -1,11 +1,16 @@
 #ifndef SHORTESTPATHBF_HPP
 #define SHORTESTPATHBF_HPP
 
+#include "EdgeRelaxation.hpp"
 #include "Graph.hpp"
+#include "SearchWorkspace.hpp"
 #include "utility.hpp"
+#include <cassert>
 #include <deque>
 #include <iterator>
+#include <limits>
 #include <type_traits>
+#include <vector>
 
 template <typename G,
     typename DistanceComparator = std::less<typename G::weight_type>>
@@ -15,19 +20,18 @@ class ShortestPathBellmanFord {
   public:
     struct NegativeCycleException {
         Graph::Edge message;
+        // Closed path of the cycle, when known
+        Graph::Path cycle{};
     };
 
     explicit ShortestPathBellmanFord(
         const G& _graph, DistanceComparator _distComp = DistanceComparator())
         : m_graph(&_graph)
         , m_distComp(_distComp)
-        , m_distance(
-              m_graph->getOrder(), std::numeric_limits<weight_type>::max())
-        , m_parent(m_graph->getOrder(), -1)
-        , m_inQueue(m_graph->getOrder(), false)
-        , m_count(m_graph->getOrder(), 0)
-
-    {}
+        , m_workspace(m_graph->getOrder())
+        , m_next(m_graph->getOrder())
+        , m_prev(m_graph->getOrder())
+        , m_depth(m_graph->getOrder()) {}
 
     ShortestPathBellmanFord(const ShortestPathBellmanFord& _other) = default;
     ShortestPathBellmanFord(
@@ -38,53 +42,133 @@ class ShortestPathBellmanFord {
         ShortestPathBellmanFord&& _other) noexcept = default;
     ~ShortestPathBellmanFord() = default;
 
-    void clear() {
-        std::fill(m_parent.begin(), m_parent.end(), -1);
-        std::fill(m_distance.begin(), m_distance.end(),
-            std::numeric_limits<weight_type>::max());
-        std::fill(m_inQueue.begin(), m_inQueue.end(), false);
-        std::fill(m_count.begin(), m_count.end(), 0);
-    }
+    /**
+     * \brief Reset the distances, parents, queue flags and relaxation counts
+     * in O(1)
+     */
+    void clear() { m_workspace.reset(); }
 
     inline Graph::Path getShortestPath(
         const Graph::Node _s, const Graph::Node _t) {
-        return getShortestPath_v2(_s, _t);
+        computeShortestPathTree(_s);
+        Graph::Path path;
+        if (m_workspace.getParent(_t) != -1) {
+            Graph::Node node = _t;
+            while (node != _s) {
+                path.push_back(node);
+                node = m_workspace.getParent(node);
+            }
+            path.push_back(node);
+            std::reverse(path.begin(), path.end());
+        }
+        return path;
     }
 
     weight_type getDistance(const Graph::Node _u) const {
-        return m_distance[_u];
+        return m_workspace.getDistance(_u);
+    }
+
+    /**
+     * \brief Compute the shortest path tree rooted at _s
+     * Queue based Bellman-Ford (SPFA) with the small label first and large
+     * label last queue heuristics, and Tarjan's subtree disassembly: when the
+     * distance of a node decreases, its subtree is removed from the tree and
+     * its queued nodes are not scanned until they improve again, since their
+     * distance is outdated. A negative cycle is found as soon as a node
+     * improves one of its own ancestors, without a final pass over the edges.
+     * Throws NegativeCycleException if a negative cycle is reachable from _s.
+     */
+    void computeShortestPathTree(const Graph::Node _s) {
+        Graph::Path cycle;
+        if (search(_s, cycle)) {
+            throw NegativeCycleException{
+                {cycle[cycle.size() - 2], cycle.back()}, cycle};
+        }
+    }
+
+    /**
+     * \brief Compute the shortest path tree rooted at _s and write a negative
+     * cycle reachable from _s into _cycle, as a closed path starting and
+     * ending at the same node. Returns false, with an empty _cycle, if there
+     * is none.
+     */
+    bool findNegativeCycle(const Graph::Node _s, Graph::Path& _cycle) {
+        return search(_s, _cycle);
+    }
+
+    /**
+     * \brief Compute the shortest path tree rooted at _s with full sweeps over
+     * the edges, stopping at the first sweep without change
+     * The edges are copied once into contiguous arrays and relaxed with the
+     * fastest kernel supported by the CPU (see EdgeRelaxation.hpp), which
+     * suits dense graphs where most edges are relaxed at each sweep.
+     * Distances are compared with operator<, not DistanceComparator.
+     * Throws NegativeCycleException if a negative cycle is reachable from _s.
+     */
+    void computeShortestPathTreeBySweeps(const Graph::Node _s) {
+        const int order = m_graph->getOrder();
+        m_edgeArrays.assign(*m_graph);
+        m_sweepDistance.assign(order, std::numeric_limits<weight_type>::max());
+        m_sweepParent.assign(order, -1);
+        m_sweepDistance[_s] = 0;
+        m_sweepParent[_s] = _s;
+        bool anyChange = true;
+        for (int i = 0; i < order && anyChange; ++i) {
+            anyChange =
+                relaxEdges(m_edgeArrays, m_sweepDistance, m_sweepParent);
+        }
+
+        clear();
+        for (Graph::Node u = 0; u < order; ++u) {
+            if (m_sweepParent[u] != -1) {
+                m_workspace[u].distance = m_sweepDistance[u];
+                m_workspace[u].parent = m_sweepParent[u];
+            }
+        }
+        if (anyChange) {
+            // Still improving after n sweeps: the parent graph has a cycle
+            Graph::Path cycle;
+            [[maybe_unused]] const bool found = findParentCycle(cycle);
+            assert(found);
+            throw NegativeCycleException{
+                {cycle[cycle.size() - 2], cycle.back()}, cycle};
+        }
+    }
+
+    Graph::Node getParent(const Graph::Node _u) const {
+        return m_workspace.getParent(_u);
     }
 
     Graph::Path getShortestPath_v1(const Graph::Node _s, const Graph::Node _t) {
         clear();
-        m_parent[_s] = _s;
-        m_distance[_s] = 0;
+        m_workspace[_s].parent = _s;
+        m_workspace[_s].distance = 0;
         const auto edges = m_graph->getEdges();
         for (int i = 0; i < m_graph->getOrder() - 1; ++i) {
             for (const auto& edge : edges) {
-                const weight_type dist =
-                    m_distance[edge.first] + m_graph->getEdgeWeight(edge);
-                if (m_distComp(dist, m_distance[edge.second])) {
-                    m_distance[edge.second] = dist;
-                    m_parent[edge.second] = edge.first;
+                const weight_type dist = m_workspace.getDistance(edge.first)
+                                         + m_graph->getEdgeWeight(edge);
+                if (m_distComp(dist, m_workspace.getDistance(edge.second))) {
+                    m_workspace[edge.second].distance = dist;
+                    m_workspace[edge.second].parent = edge.first;
                 }
             }
         }
 
         for (const auto& edge : m_graph->getEdges()) {
-            if (m_distComp(
-                    m_distance[edge.first] + m_graph->getEdgeWeight(edge),
-                    m_distance[edge.second])) {
+            if (m_distComp(m_workspace.getDistance(edge.first)
+                           + m_graph->getEdgeWeight(edge),
+                    m_workspace.getDistance(edge.second))) {
                 throw NegativeCycleException{edge};
             }
         }
 
         Graph::Path path;
-        if (m_parent[_t] != -1) {
+        if (m_workspace.getParent(_t) != -1) {
             Graph::Node node = _t;
             while (node != _s) {
                 path.push_back(node);
-                node = m_parent[node];
+                node = m_workspace.getParent(node);
             }
             path.push_back(node);
             std::reverse(path.begin(), path.end());
@@ -94,38 +178,38 @@ class ShortestPathBellmanFord {
 
     Graph::Path getShortestPath_v2(const Graph::Node _s, const Graph::Node _t) {
         clear();
-        m_parent[_s] = _s;
-        m_distance[_s] = 0;
+        m_workspace[_s].parent = _s;
+        m_workspace[_s].distance = 0;
         const auto edges = m_graph->getEdges();
         bool anyChanges = true;
         for (int i = 0; i < m_graph->getOrder() - 1 && anyChanges == true;
              ++i) {
             anyChanges = false;
             for (const auto& edge : edges) {
-                const weight_type dist =
-                    m_distance[edge.first] + m_graph->getEdgeWeight(edge);
-                if (m_distComp(dist, m_distance[edge.second])) {
+                const weight_type dist = m_workspace.getDistance(edge.first)
+                                         + m_graph->getEdgeWeight(edge);
+                if (m_distComp(dist, m_workspace.getDistance(edge.second))) {
                     anyChanges = true;
-                    m_distance[edge.second] = dist;
-                    m_parent[edge.second] = edge.first;
+                    m_workspace[edge.second].distance = dist;
+                    m_workspace[edge.second].parent = edge.first;
                 }
             }
         }
 
         for (const auto& edge : m_graph->getEdges()) {
-            if (m_distComp(
-                    m_distance[edge.first] + m_graph->getEdgeWeight(edge),
-                    m_distance[edge.second])) {
+            if (m_distComp(m_workspace.getDistance(edge.first)
+                           + m_graph->getEdgeWeight(edge),
+                    m_workspace.getDistance(edge.second))) {
                 throw NegativeCycleException{edge};
             }
         }
 
         Graph::Path path;
-        if (m_parent[_t] != -1) {
+        if (m_workspace.getParent(_t) != -1) {
             Graph::Node node = _t;
             while (node != _s) {
                 path.push_back(node);
-                node = m_parent[node];
+                node = m_workspace.getParent(node);
             }
             path.push_back(node);
             std::reverse(path.begin(), path.end());
@@ -135,33 +219,34 @@ class ShortestPathBellmanFord {
 
     Graph::Path getShortestPath_v3(const Graph::Node _s, const Graph::Node _t) {
         clear();
-        m_parent[_s] = _s;
-        m_distance[_s] = 0;
+        m_workspace[_s].parent = _s;
+        m_workspace[_s].distance = 0;
         const auto edges = m_graph->getEdges();
 
         std::deque<Graph::Node> queue{_s};
 
-        m_inQueue[_s] = true;
+        m_workspace[_s].color = 1;
 
         bool overRelaxed = false;
         while (!queue.empty() && !overRelaxed) {
             const auto u = queue.front();
             queue.pop_front();
-            m_inQueue[u] = false;
+            m_workspace[u].color = 0;
             // Don't try to relax if parent is in queue
-            if (m_parent[u] == -1 || !m_inQueue[m_parent[u]]) {
+            if (m_workspace.getParent(u) == -1
+                || !m_workspace.getColor(m_workspace.getParent(u))) {
                 for (const auto v : m_graph->getNeighbors(u)) {
-                    const weight_type dist =
-                        m_distance[u] + m_graph->getEdgeWeight(u, v);
-                    if (m_distComp(dist, m_distance[v])) {
-                        if (++m_count[v] == m_graph->getOrder()) {
+                    const weight_type dist = m_workspace.getDistance(u)
+                                             + m_graph->getEdgeWeight(u, v);
+                    if (m_distComp(dist, m_workspace.getDistance(v))) {
+                        if (++m_workspace[v].count == m_graph->getOrder()) {
                             overRelaxed = true;
                         }
-                        m_distance[v] = dist;
-                        m_parent[v] = u;
-                        if (!m_inQueue[v]) {
+                        m_workspace[v].distance = dist;
+                        m_workspace[v].parent = u;
+                        if (!m_workspace.getColor(v)) {
                             queue.push_back(v);
-                            m_inQueue[v] = true;
+                            m_workspace[v].color = 1;
                         }
                     }
                 }
@@ -169,19 +254,19 @@ class ShortestPathBellmanFord {
         }
 
         for (const auto& edge : m_graph->getEdges()) {
-            if (m_distComp(
-                    m_distance[edge.first] + m_graph->getEdgeWeight(edge),
-                    m_distance[edge.second])) {
+            if (m_distComp(m_workspace.getDistance(edge.first)
+                           + m_graph->getEdgeWeight(edge),
+                    m_workspace.getDistance(edge.second))) {
                 throw NegativeCycleException{edge};
             }
         }
 
         Graph::Path path;
-        if (m_parent[_t] != -1) {
+        if (m_workspace.getParent(_t) != -1) {
             Graph::Node node = _t;
             while (node != _s) {
                 path.push_back(node);
-                node = m_parent[node];
+                node = m_workspace.getParent(node);
             }
             path.push_back(node);
             std::reverse(path.begin(), path.end());
@@ -192,8 +277,8 @@ class ShortestPathBellmanFord {
     Graph::Path getShortestPath_YenFirst(
         const Graph::Node _s, const Graph::Node _t) {
         clear();
-        m_parent[_s] = _s;
-        m_distance[_s] = 0;
+        m_workspace[_s].parent = _s;
+        m_workspace[_s].distance = 0;
         const auto edges = m_graph->getEdges();
         bool anyChanges = true;
         std::vector<int> nbOutEdgeChange(m_graph->getOrder(), 0.0);
@@ -205,12 +290,13 @@ class ShortestPathBellmanFord {
             int e = 0;
             for (const auto& edge : edges) {
                 if (edgeToRelax[e]) {
-                    const weight_type dist =
-                        m_distance[edge.first] + m_graph->getEdgeWeight(edge);
-                    if (m_distComp(dist, m_distance[edge.second])) {
+                    const weight_type dist = m_workspace.getDistance(edge.first)
+                                             + m_graph->getEdgeWeight(edge);
+                    if (m_distComp(
+                            dist, m_workspace.getDistance(edge.second))) {
                         anyChanges = true;
-                        m_distance[edge.second] = dist;
-                        m_parent[edge.second] = edge.first;
+                        m_workspace[edge.second].distance = dist;
+                        m_workspace[edge.second].parent = edge.first;
                         nbOutEdgeChange[edge.second] = 0;
                     } else {
                         nbOutEdgeChange[edge.second]++;
@@ -227,19 +313,19 @@ class ShortestPathBellmanFord {
             }
         }
         for (const auto& edge : m_graph->getEdges()) {
-            if (m_distComp(
-                    m_distance[edge.first] + m_graph->getEdgeWeight(edge),
-                    m_distance[edge.second])) {
+            if (m_distComp(m_workspace.getDistance(edge.first)
+                           + m_graph->getEdgeWeight(edge),
+                    m_workspace.getDistance(edge.second))) {
                 throw NegativeCycleException{edge};
             }
         }
 
         Graph::Path path;
-        if (m_parent[_t] != -1) {
+        if (m_workspace.getParent(_t) != -1) {
             Graph::Node node = _t;
             while (node != _s) {
                 path.push_back(node);
-                node = m_parent[node];
+                node = m_workspace.getParent(node);
             }
             path.push_back(node);
             std::reverse(path.begin(), path.end());
@@ -250,8 +336,8 @@ class ShortestPathBellmanFord {
     Graph::Path getShortestPath_YenFirst_doublevector(
         const Graph::Node _s, const Graph::Node _t) {
         clear();
-        m_parent[_s] = _s;
-        m_distance[_s] = 0;
+        m_workspace[_s].parent = _s;
+        m_workspace[_s].distance = 0;
         auto edges = m_graph->getEdges();
         const auto allEdges = m_graph->getEdges();
         bool anyChanges = true;
@@ -262,12 +348,12 @@ class ShortestPathBellmanFord {
             anyChanges = false;
             // std::fill(nbOutEdgeChange.begin(), nbOutEdgeChange.end(), 0.0);
             for (const auto& edge : edges) {
-                const weight_type dist =
-                    m_distance[edge.first] + m_graph->getEdgeWeight(edge);
-                if (m_distComp(dist, m_distance[edge.second])) {
+                const weight_type dist = m_workspace.getDistance(edge.first)
+                                         + m_graph->getEdgeWeight(edge);
+                if (m_distComp(dist, m_workspace.getDistance(edge.second))) {
                     anyChanges = true;
-                    m_distance[edge.second] = dist;
-                    m_parent[edge.second] = edge.first;
+                    m_workspace[edge.second].distance = dist;
+                    m_workspace[edge.second].parent = edge.first;
                     nbOutEdgeChange[edge.second] = 0;
                 } else {
                     nbOutEdgeChange[edge.second]++;
@@ -282,19 +368,19 @@ class ShortestPathBellmanFord {
                 });
         }
         for (const auto& edge : m_graph->getEdges()) {
-            if (m_distComp(
-                    m_distance[edge.first] + m_graph->getEdgeWeight(edge),
-                    m_distance[edge.second])) {
+            if (m_distComp(m_workspace.getDistance(edge.first)
+                           + m_graph->getEdgeWeight(edge),
+                    m_workspace.getDistance(edge.second))) {
                 throw NegativeCycleException{edge};
             }
         }
 
         Graph::Path path;
-        if (m_parent[_t] != -1) {
+        if (m_workspace.getParent(_t) != -1) {
             Graph::Node node = _t;
             while (node != _s) {
                 path.push_back(node);
-                node = m_parent[node];
+                node = m_workspace.getParent(node);
             }
             path.push_back(node);
             std::reverse(path.begin(), path.end());
@@ -305,8 +391,8 @@ class ShortestPathBellmanFord {
     Graph::Path getShortestPath_YenFirst_partition(
         const Graph::Node _s, const Graph::Node _t) {
         clear();
-        m_parent[_s] = _s;
-        m_distance[_s] = 0;
+        m_workspace[_s].parent = _s;
+        m_workspace[_s].distance = 0;
         auto edges = m_graph->getEdges();
         bool anyChanges = true;
         std::vector<int> nbOutEdgeChange(m_graph->getOrder(), 0.0);
@@ -316,13 +402,13 @@ class ShortestPathBellmanFord {
              ++i) {
             anyChanges = false;
             for (auto ite = edges.begin(); ite != iteEnd; ++ite) {
-                const weight_type dist =
-                    m_distance[(*ite).first] + m_graph->getEdgeWeight(*ite);
+                const weight_type dist = m_workspace.getDistance((*ite).first)
+                                         + m_graph->getEdgeWeight(*ite);
                 nbOutEdgeChange[(*ite).second]++;
-                if (m_distComp(dist, m_distance[(*ite).second])) {
+                if (m_distComp(dist, m_workspace.getDistance((*ite).second))) {
                     anyChanges = true;
-                    m_distance[(*ite).second] = dist;
-                    m_parent[(*ite).second] = (*ite).first;
+                    m_workspace[(*ite).second].distance = dist;
+                    m_workspace[(*ite).second].parent = (*ite).first;
                     nbOutEdgeChange[(*ite).second] = 0;
                 }
             }
@@ -333,19 +419,19 @@ class ShortestPathBellmanFord {
                 });
         }
         for (const auto& edge : m_graph->getEdges()) {
-            if (m_distComp(
-                    m_distance[edge.first] + m_graph->getEdgeWeight(edge),
-                    m_distance[edge.second])) {
+            if (m_distComp(m_workspace.getDistance(edge.first)
+                           + m_graph->getEdgeWeight(edge),
+                    m_workspace.getDistance(edge.second))) {
                 throw NegativeCycleException{edge};
             }
         }
 
         Graph::Path path;
-        if (m_parent[_t] != -1) {
+        if (m_workspace.getParent(_t) != -1) {
             Graph::Node node = _t;
             while (node != _s) {
                 path.push_back(node);
-                node = m_parent[node];
+                node = m_workspace.getParent(node);
             }
             path.push_back(node);
             std::reverse(path.begin(), path.end());
@@ -356,8 +442,8 @@ class ShortestPathBellmanFord {
     Graph::Path getShortestPath_YenSecond_partition(
         const Graph::Node _s, const Graph::Node _t) {
         clear();
-        m_parent[_s] = _s;
-        m_distance[_s] = 0;
+        m_workspace[_s].parent = _s;
+        m_workspace[_s].distance = 0;
         auto edges = m_graph->getEdges();
         const auto iteSecondBegin = std::partition(
             edges.begin(), edges.end(), [&](const Graph::Edge& _edge) {
@@ -372,24 +458,24 @@ class ShortestPathBellmanFord {
              ++i) {
             anyChanges = false;
             for (auto ite = edges.begin(); ite != iteFirstEnd; ++ite) {
-                const weight_type dist =
-                    m_distance[(*ite).first] + m_graph->getEdgeWeight(*ite);
+                const weight_type dist = m_workspace.getDistance((*ite).first)
+                                         + m_graph->getEdgeWeight(*ite);
                 nbOutEdgeChange[(*ite).second]++;
-                if (m_distComp(dist, m_distance[(*ite).second])) {
+                if (m_distComp(dist, m_workspace.getDistance((*ite).second))) {
                     anyChanges = true;
-                    m_distance[(*ite).second] = dist;
-                    m_parent[(*ite).second] = (*ite).first;
+                    m_workspace[(*ite).second].distance = dist;
+                    m_workspace[(*ite).second].parent = (*ite).first;
                     nbOutEdgeChange[(*ite).second] = 0;
                 }
             }
             for (auto ite = iteSecondBegin; ite != iteSecondEnd; ++ite) {
-                const weight_type dist =
-                    m_distance[(*ite).first] + m_graph->getEdgeWeight(*ite);
+                const weight_type dist = m_workspace.getDistance((*ite).first)
+                                         + m_graph->getEdgeWeight(*ite);
                 nbOutEdgeChange[(*ite).second]++;
-                if (m_distComp(dist, m_distance[(*ite).second])) {
+                if (m_distComp(dist, m_workspace.getDistance((*ite).second))) {
                     anyChanges = true;
-                    m_distance[(*ite).second] = dist;
-                    m_parent[(*ite).second] = (*ite).first;
+                    m_workspace[(*ite).second].distance = dist;
+                    m_workspace[(*ite).second].parent = (*ite).first;
                     nbOutEdgeChange[(*ite).second] = 0;
                 }
             }
@@ -406,19 +492,19 @@ class ShortestPathBellmanFord {
         }
 
         for (const auto& edge : m_graph->getEdges()) {
-            if (m_distComp(
-                    m_distance[edge.first] + m_graph->getEdgeWeight(edge),
-                    m_distance[edge.second])) {
+            if (m_distComp(m_workspace.getDistance(edge.first)
+                           + m_graph->getEdgeWeight(edge),
+                    m_workspace.getDistance(edge.second))) {
                 throw NegativeCycleException{edge};
             }
         }
 
         Graph::Path path;
-        if (m_parent[_t] != -1) {
+        if (m_workspace.getParent(_t) != -1) {
             Graph::Node node = _t;
             while (node != _s) {
                 path.push_back(node);
-                node = m_parent[node];
+                node = m_workspace.getParent(node);
             }
             path.push_back(node);
             std::reverse(path.begin(), path.end());
@@ -427,12 +513,209 @@ class ShortestPathBellmanFord {
     }
 
   private:
+    // Colors of the nodes in the workspace
+    static constexpr char NOT_QUEUED = 0;
+    static constexpr char QUEUED = 1;
+    // Queued node whose subtree was disassembled, skipped when popped
+    static constexpr char INACTIVE = 2;
+
+    /**
+     * SPFA with subtree disassembly from _s. Returns true and writes the
+     * negative cycle into _cycle if one is found.
+     */
+    bool search(Graph::Node _s, Graph::Path& _cycle);
+
+    /**
+     * Remove the subtree of _v from the shortest path tree, _v excepted, and
+     * deactivate its queued nodes. Returns false if _u belongs to the subtree,
+     * in which case nothing is changed and the edge (_u, _v) closes a negative
+     * cycle.
+     */
+    bool disassembleSubtree(
+        Graph::Node _u, Graph::Node _v, double& _queueSum);
+
+    /**
+     * Write a cycle of the parent graph into _cycle, as a closed path. Each
+     * walk up the parent pointers stops at the first node already visited,
+     * so the search is O(n).
+     */
+    bool findParentCycle(Graph::Path& _cycle) const;
+
+    /**
+     * The shortest path tree is kept as a circular list of its nodes in
+     * preorder, rooted at the source, with the depth of each node. A touched
+     * node is out of the tree if its previous node is -1.
+     */
+    void unlink(const Graph::Node _first, const Graph::Node _last) {
+        m_next[m_prev[_first]] = m_next[_last];
+        m_prev[m_next[_last]] = m_prev[_first];
+    }
+
+    void insertAfter(const Graph::Node _u, const Graph::Node _v) {
+        m_next[_v] = m_next[_u];
+        m_prev[m_next[_u]] = _v;
+        m_next[_u] = _v;
+        m_prev[_v] = _u;
+        m_depth[_v] = m_depth[_u] + 1;
+    }
+
     G const* m_graph;
     DistanceComparator m_distComp;
-    std::vector<weight_type> m_distance;
-    std::vector<int> m_parent;
-    std::vector<char> m_inQueue;
-    std::vector<int> m_count;
+    SearchWorkspace<weight_type> m_workspace;
+    std::deque<Graph::Node> m_queue{};
+    std::vector<Graph::Node> m_next;
+    std::vector<Graph::Node> m_prev;
+    std::vector<int> m_depth;
+    EdgeArrays<weight_type> m_edgeArrays{};
+    std::vector<weight_type> m_sweepDistance{};
+    std::vector<Graph::Node> m_sweepParent{};
 };
 
+template <typename G, typename DistanceComparator>
+bool ShortestPathBellmanFord<G, DistanceComparator>::search(
+    const Graph::Node _s, Graph::Path& _cycle) {
+    _cycle.clear();
+    clear();
+    m_queue.clear();
+    auto& source = m_workspace[_s];
+    source.parent = _s;
+    source.distance = 0;
+    source.color = QUEUED;
+    m_queue.push_back(_s);
+    m_next[_s] = _s;
+    m_prev[_s] = _s;
+    m_depth[_s] = 0;
+    // Kept as a double, since the sum of the distances overflows integer
+    // weights long before the distances do
+    double queueSum = 0.0;
+
+    while (!m_queue.empty()) {
+        // Large label last: move the front behind while it is above the mean
+        // of the queue
+        const auto mean = static_cast<weight_type>(
+            queueSum / static_cast<double>(m_queue.size()));
+        const auto isAboveMean = [&](const Graph::Node _u) {
+            return m_workspace.at(_u).color == QUEUED
+                   && m_distComp(mean, m_workspace.at(_u).distance);
+        };
+        for (std::size_t i = 1;
+             i < m_queue.size() && isAboveMean(m_queue.front()); ++i) {
+            m_queue.push_back(m_queue.front());
+            m_queue.pop_front();
+        }
+        const auto u = m_queue.front();
+        m_queue.pop_front();
+        auto& stateU = m_workspace[u];
+        const bool inactive = stateU.color == INACTIVE;
+        stateU.color = NOT_QUEUED;
+        if (inactive) {
+            continue;
+        }
+        queueSum -= stateU.distance;
+
+        for (const auto v : m_graph->getNeighbors(u)) {
+            const weight_type dist =
+                stateU.distance + m_graph->getEdgeWeight(u, v);
+            const bool inTree = m_workspace.isTouched(v) && m_prev[v] != -1;
+            auto& stateV = m_workspace[v];
+            if (!m_distComp(dist, stateV.distance)) {
+                continue;
+            }
+            if (u == v || (inTree && !disassembleSubtree(u, v, queueSum))) {
+                // Negative cycle v -> ... -> u -> v along the tree
+                for (Graph::Node node = u; node != v;
+                     node = m_workspace.getParent(node)) {
+                    _cycle.push_back(node);
+                }
+                _cycle.push_back(v);
+                std::reverse(_cycle.begin(), _cycle.end());
+                _cycle.push_back(v);
+                return true;
+            }
+            if (inTree) {
+                unlink(v, v);
+            }
+            insertAfter(u, v);
+
+            if (stateV.color == QUEUED) {
+                queueSum += dist - stateV.distance;
+            } else {
+                if (stateV.color == NOT_QUEUED) {
+                    // Small label first
+                    if (!m_queue.empty()
+                        && m_distComp(
+                            dist, m_workspace.at(m_queue.front()).distance)) {
+                        m_queue.push_front(v);
+                    } else {
+                        m_queue.push_back(v);
+                    }
+                }
+                queueSum += dist;
+                stateV.color = QUEUED;
+            }
+            stateV.distance = dist;
+            stateV.parent = u;
+        }
+    }
+    return false;
+}
+
+template <typename G, typename DistanceComparator>
+bool ShortestPathBellmanFord<G, DistanceComparator>::disassembleSubtree(
+    const Graph::Node _u, const Graph::Node _v, double& _queueSum) {
+    // The subtree of _v is the run of deeper nodes following it in preorder
+    Graph::Node last = _v;
+    for (Graph::Node x = m_next[_v]; m_depth[x] > m_depth[_v];
+         x = m_next[x]) {
+        if (x == _u) {
+            return false;
+        }
+        last = x;
+    }
+    if (last == _v) {
+        return true;
+    }
+    const auto first = m_next[_v];
+    unlink(first, last);
+    for (Graph::Node x = first;; x = m_next[x]) {
+        auto& stateX = m_workspace[x];
+        if (stateX.color == QUEUED) {
+            stateX.color = INACTIVE;
+            _queueSum -= stateX.distance;
+        }
+        m_prev[x] = -1;
+        if (x == last) {
+            break;
+        }
+    }
+    return true;
+}
+
+template <typename G, typename DistanceComparator>
+bool ShortestPathBellmanFord<G, DistanceComparator>::findParentCycle(
+    Graph::Path& _cycle) const {
+    const int order = m_graph->getOrder();
+    std::vector<Graph::Node> walkIds(order, -1);
+    _cycle.clear();
+    for (Graph::Node u = 0; u < order; ++u) {
+        Graph::Node node = u;
+        while (node != -1 && walkIds[node] == -1) {
+            walkIds[node] = u;
+            const auto parent = m_workspace.getParent(node);
+            node = parent == node ? -1 : parent;
+        }
+        if (node != -1 && walkIds[node] == u) {
+            _cycle.push_back(node);
+            for (auto x = m_workspace.getParent(node); x != node;
+                 x = m_workspace.getParent(x)) {
+                _cycle.push_back(x);
+            }
+            _cycle.push_back(node);
+            std::reverse(_cycle.begin(), _cycle.end());
+            return true;
+        }
+    }
+    return false;
+}
+
 #endif
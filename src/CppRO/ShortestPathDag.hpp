@@ -0,0 +1,255 @@
+#ifndef SHORTESTPATHDAG_HPP
+#define SHORTESTPATHDAG_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include <omp.h>
+
+#include "Graph.hpp"
+#include "Matrix.hpp"
+#include "ShortestPath.hpp"
+
+/**
+ * Every shortest path from a root, stored as the DAG of the tight edges
+ * (u, v), d(u) + w(u, v) = d(v), with the predecessors of each node in
+ * compressed sparse rows.
+ *
+ * The DAG gives the number of shortest paths to each node, and the ECMP
+ * routing of traffic from the root: each node splits the traffic it receives
+ * for a target equally among its next hops on a shortest path to the target.
+ * A routing only walks the part of the DAG leading to the target, instead of
+ * enumerating the equal cost paths.
+ *
+ * Edge weights must be positive, so that the nodes are settled in a
+ * topological order of the DAG, and must add up exactly (e.g. integer values)
+ * for the equal cost paths to be recognized.
+ */
+template <typename G>
+class ShortestPathDag {
+  public:
+    using weight_type = typename G::weight_type;
+
+    /**
+     * Traffic to route from source to target
+     */
+    struct Demand {
+        Graph::Node source;
+        Graph::Node target;
+        double volume;
+    };
+
+    explicit ShortestPathDag(const G& _graph)
+        : m_graph(&_graph)
+        , m_shortestPath(_graph)
+        , m_offsets(_graph.getOrder() + 1, 0)
+        , m_nbPaths(_graph.getOrder(), 0.0)
+        , m_nbNextHops(_graph.getOrder(), 0)
+        , m_traffic(_graph.getOrder(), 0.0) {}
+
+    /**
+     * \brief Compute the shortest path DAG rooted at _s
+     */
+    void computeShortestPathDag(Graph::Node _s);
+
+    Graph::Node getRoot() const { return m_root; }
+
+    weight_type getDistance(const Graph::Node _u) const {
+        return m_shortestPath.getDistance(_u);
+    }
+
+    /**
+     * \brief Returns the nodes reached from the root, in a topological order
+     * of the DAG
+     */
+    const std::vector<Graph::Node>& getSettledNodes() const {
+        return m_shortestPath.getSettledNodes();
+    }
+
+    /**
+     * \brief Returns the nodes u such that (u, v) is on a shortest path to v
+     */
+    std::span<const Graph::Node> getPredecessors(const Graph::Node _v) const {
+        return {m_predecessors.data() + m_offsets[_v],
+            m_predecessors.data() + m_offsets[_v + 1]};
+    }
+
+    /**
+     * \brief Number of shortest paths from the root to _u, 0 if _u is not
+     * reachable
+     * Kept as a double since the number of paths grows exponentially.
+     */
+    double getNbPaths(const Graph::Node _u) const { return m_nbPaths[_u]; }
+
+    /**
+     * \brief Route _volume from the root to _t with ECMP, adding the traffic
+     * of each edge (u, v) to _loads(u, v)
+     * Returns false if _t is not reachable.
+     */
+    bool addEcmpLoads(Graph::Node _t, double _volume, Matrix<double>& _loads);
+
+    /**
+     * \brief Route every demand with ECMP and write the total traffic of each
+     * edge (u, v) into _loads(u, v)
+     * The demands are grouped by source, and the DAG of each source is
+     * computed once, on one of _nbThreads threads. Each thread accumulates
+     * its own loads, which are summed at the end. Demands whose target is not
+     * reachable are ignored.
+     */
+    void computeEcmpLoads(const std::vector<Demand>& _demands,
+        Matrix<double>& _loads, int _nbThreads = omp_get_max_threads()) const;
+
+  private:
+    G const* m_graph;
+    ShortestPath<G> m_shortestPath;
+    Graph::Node m_root{-1};
+    std::vector<int> m_offsets;
+    std::vector<Graph::Node> m_predecessors{};
+    std::vector<double> m_nbPaths;
+    // Routing state, reset after each routing
+    std::vector<int> m_nbNextHops;
+    std::vector<double> m_traffic;
+    std::vector<Graph::Node> m_stack{};
+    std::vector<Graph::Node> m_routed{};
+};
+
+template <typename G>
+void ShortestPathDag<G>::computeShortestPathDag(const Graph::Node _s) {
+    for (const auto u : m_shortestPath.getSettledNodes()) {
+        m_nbPaths[u] = 0.0;
+    }
+    m_root = _s;
+    m_shortestPath.computeShortestPathTree(_s);
+    const auto& settled = m_shortestPath.getSettledNodes();
+    const auto isTight = [&](const Graph::Node _u, const Graph::Node _v) {
+        assert(m_graph->getEdgeWeight(_u, _v) > 0);
+        return m_shortestPath.getDistance(_u) + m_graph->getEdgeWeight(_u, _v)
+               == m_shortestPath.getDistance(_v);
+    };
+
+    // Rows are filled backward from their end, which leaves m_offsets[v] at
+    // the start of row v
+    std::fill(m_offsets.begin(), m_offsets.end(), 0);
+    for (const auto u : settled) {
+        for (const auto v : m_graph->getNeighbors(u)) {
+            if (isTight(u, v)) {
+                ++m_offsets[v];
+            }
+        }
+    }
+    std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+    m_predecessors.resize(m_offsets.back());
+    for (auto ite = settled.rbegin(); ite != settled.rend(); ++ite) {
+        const auto u = *ite;
+        for (const auto v : m_graph->getNeighbors(u)) {
+            if (isTight(u, v)) {
+                m_predecessors[--m_offsets[v]] = u;
+            }
+        }
+    }
+
+    m_nbPaths[_s] = 1.0;
+    for (const auto v : settled) {
+        for (const auto u : getPredecessors(v)) {
+            m_nbPaths[v] += m_nbPaths[u];
+        }
+    }
+}
+
+template <typename G>
+bool ShortestPathDag<G>::addEcmpLoads(
+    const Graph::Node _t, const double _volume, Matrix<double>& _loads) {
+    if (m_shortestPath.getDistance(_t)
+        == std::numeric_limits<weight_type>::max()) {
+        return false;
+    }
+    // The nodes leading to _t are the ancestors of _t in the DAG, and their
+    // next hops are their successors among them
+    m_stack.assign(1, _t);
+    m_routed.assign(1, _t);
+    while (!m_stack.empty()) {
+        const auto v = m_stack.back();
+        m_stack.pop_back();
+        for (const auto u : getPredecessors(v)) {
+            if (m_nbNextHops[u]++ == 0) {
+                m_stack.push_back(u);
+                m_routed.push_back(u);
+            }
+        }
+    }
+
+    // Every predecessor of a node leading to _t also leads to _t, and is
+    // settled before it
+    m_traffic[m_root] = _volume;
+    for (const auto v : m_shortestPath.getSettledNodes()) {
+        if (m_nbNextHops[v] == 0 && v != _t) {
+            continue;
+        }
+        for (const auto u : getPredecessors(v)) {
+            const double traffic = m_traffic[u] / m_nbNextHops[u];
+            _loads(u, v) += traffic;
+            m_traffic[v] += traffic;
+        }
+        if (v == _t) {
+            break;
+        }
+    }
+
+    for (const auto u : m_routed) {
+        m_nbNextHops[u] = 0;
+        m_traffic[u] = 0.0;
+    }
+    return true;
+}
+
+template <typename G>
+void ShortestPathDag<G>::computeEcmpLoads(const std::vector<Demand>& _demands,
+    Matrix<double>& _loads, const int _nbThreads) const {
+    std::vector<std::size_t> demands(_demands.size());
+    std::iota(demands.begin(), demands.end(), 0);
+    std::stable_sort(demands.begin(), demands.end(),
+        [&](const std::size_t _i, const std::size_t _j) {
+            return _demands[_i].source < _demands[_j].source;
+        });
+    std::vector<std::size_t> groupStarts;
+    for (std::size_t i = 0; i < demands.size(); ++i) {
+        if (i == 0
+            || _demands[demands[i]].source != _demands[demands[i - 1]].source) {
+            groupStarts.push_back(i);
+        }
+    }
+    groupStarts.push_back(demands.size());
+    const std::size_t nbGroups = groupStarts.size() - 1;
+
+    const int order = m_graph->getOrder();
+    _loads.fill(0.0);
+#pragma omp parallel num_threads(_nbThreads)
+    {
+        ShortestPathDag dag(*m_graph);
+        Matrix<double> loads(order, order, 0.0);
+#pragma omp for schedule(dynamic)
+        for (std::size_t group = 0; group < nbGroups; ++group) {
+            dag.computeShortestPathDag(
+                _demands[demands[groupStarts[group]]].source);
+            for (std::size_t i = groupStarts[group];
+                 i < groupStarts[group + 1]; ++i) {
+                const auto& demand = _demands[demands[i]];
+                if (demand.target != demand.source) {
+                    dag.addEcmpLoads(demand.target, demand.volume, loads);
+                }
+            }
+        }
+#pragma omp critical(ShortestPathDag_loads)
+        for (Graph::Node u = 0; u < order; ++u) {
+            for (const auto v : m_graph->getNeighbors(u)) {
+                _loads(u, v) += loads(u, v);
+            }
+        }
+    }
+}
+
+#endif
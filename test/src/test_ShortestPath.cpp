@@ -0,0 +1,1273 @@
+#include <catch2/catch.hpp>
+
+#include <CppRO/AcyclicShortestPath.hpp>
+#include <CppRO/AllShortestPathBF.hpp>
+#include <CppRO/DeltaStepping.hpp>
+#include <CppRO/DiGraph.hpp>
+#include <CppRO/DisjointShortestPaths.hpp>
+#include <CppRO/DynamicShortestPath.hpp>
+#include <CppRO/EdgeRelaxation.hpp>
+#include <CppRO/FloydWarshall.hpp>
+#include <CppRO/KShortestWalks.hpp>
+#include <CppRO/LagrangianShortestPath.hpp>
+#include <CppRO/ManyToManyShortestPath.hpp>
+#include <CppRO/ParallelBellmanFord.hpp>
+#include <CppRO/PathArena.hpp>
+#include <CppRO/SearchWorkspace.hpp>
+#include <CppRO/ShortestPath.hpp>
+#include <CppRO/ShortestPathBF.hpp>
+#include <CppRO/ShortestPathDag.hpp>
+
+#include <algorithm>
+#include <random>
+#include <variant>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+
+namespace {
+DiGraph<double> getRandomGraph(
+    const int _order, const int _nbEdges, const unsigned int _seed) {
+    std::mt19937 gen(_seed);
+    std::uniform_int_distribution<Graph::Node> nodeDist(0, _order - 1);
+    std::uniform_int_distribution<int> weightDist(1, 10);
+    DiGraph<double> graph(_order);
+    for (int i = 0; i < _nbEdges; ++i) {
+        const auto u = nodeDist(gen);
+        const auto v = nodeDist(gen);
+        if (u != v) {
+            graph.addEdge(u, v, weightDist(gen));
+        }
+    }
+    return graph;
+}
+
+/**
+ * Weight of every simple path from _u to _t, by depth first search
+ */
+void getSimplePathCosts(const DiGraph<double>& _graph, const Graph::Node _u,
+    const Graph::Node _t, const double _cost, std::vector<char>& _onPath,
+    std::vector<double>& _costs) {
+    if (_u == _t) {
+        _costs.push_back(_cost);
+        return;
+    }
+    _onPath[_u] = 1;
+    for (const auto v : _graph.getNeighbors(_u)) {
+        if (!_onPath[v]) {
+            getSimplePathCosts(_graph, v, _t,
+                _cost + _graph.getEdgeWeight(_u, v), _onPath, _costs);
+        }
+    }
+    _onPath[_u] = 0;
+}
+
+/**
+ * Cost of the cheapest simple path from _u to _t with a delay of at most
+ * _maxDelay, by depth first search
+ */
+template <typename DelayFunction>
+double getBestConstrainedCost(const DiGraph<double>& _graph,
+    const Graph::Node _u, const Graph::Node _t, const double _cost,
+    const double _delay, const double _maxDelay, DelayFunction _delayOf,
+    std::vector<char>& _onPath) {
+    if (_delay > _maxDelay) {
+        return std::numeric_limits<double>::infinity();
+    }
+    if (_u == _t) {
+        return _cost;
+    }
+    double best = std::numeric_limits<double>::infinity();
+    _onPath[_u] = 1;
+    for (const auto v : _graph.getNeighbors(_u)) {
+        if (!_onPath[v]) {
+            best = std::min(best,
+                getBestConstrainedCost(_graph, v, _t,
+                    _cost + _graph.getEdgeWeight(_u, v),
+                    _delay + _delayOf(_u, v), _maxDelay, _delayOf, _onPath));
+        }
+    }
+    _onPath[_u] = 0;
+    return best;
+}
+
+/**
+ * Weight of every walk from _u to _t of weight at most _maxCost
+ */
+void getWalkCosts(const DiGraph<double>& _graph, const Graph::Node _u,
+    const Graph::Node _t, const double _cost, const double _maxCost,
+    std::vector<double>& _costs) {
+    if (_u == _t) {
+        _costs.push_back(_cost);
+    }
+    for (const auto v : _graph.getNeighbors(_u)) {
+        const auto cost = _cost + _graph.getEdgeWeight(_u, v);
+        if (cost <= _maxCost) {
+            getWalkCosts(_graph, v, _t, cost, _maxCost, _costs);
+        }
+    }
+}
+
+/**
+ * Every simple path from _u to _t, by depth first search
+ */
+void getSimplePaths(const DiGraph<double>& _graph, const Graph::Node _u,
+    const Graph::Node _t, Graph::Path& _path,
+    std::vector<Graph::Path>& _paths) {
+    _path.push_back(_u);
+    if (_u == _t) {
+        _paths.push_back(_path);
+    } else {
+        for (const auto v : _graph.getNeighbors(_u)) {
+            if (std::find(_path.begin(), _path.end(), v) == _path.end()) {
+                getSimplePaths(_graph, v, _t, _path, _paths);
+            }
+        }
+    }
+    _path.pop_back();
+}
+
+/**
+ * Returns true if the paths share no edge, or no inner node if _nodeDisjoint
+ * is set
+ */
+bool areDisjoint(const PathArena::PathView _path1,
+    const PathArena::PathView _path2, const bool _nodeDisjoint) {
+    for (std::size_t i = 1; i < _path1.size(); ++i) {
+        for (std::size_t j = 1; j < _path2.size(); ++j) {
+            if (_nodeDisjoint ? i + 1 < _path1.size() && _path1[i] == _path2[j]
+                              : _path1[i - 1] == _path2[j - 1]
+                                    && _path1[i] == _path2[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Route _volume from _u to _t with ECMP by recursion, each node splitting its
+ * traffic equally among the next hops v with w(u, v) + d(v, t) = d(u, t)
+ */
+void routeEcmp(const DiGraph<double>& _graph,
+    const ShortestPath<DiGraph<double>>& _toTarget, const Graph::Node _u,
+    const Graph::Node _t, const double _volume, Matrix<double>& _loads) {
+    if (_u == _t) {
+        return;
+    }
+    std::vector<Graph::Node> nextHops;
+    for (const auto v : _graph.getNeighbors(_u)) {
+        if (_graph.getEdgeWeight(_u, v) + _toTarget.getDistance(v)
+            == _toTarget.getDistance(_u)) {
+            nextHops.push_back(v);
+        }
+    }
+    for (const auto v : nextHops) {
+        const double volume = _volume / static_cast<double>(nextHops.size());
+        _loads(_u, v) += volume;
+        routeEcmp(_graph, _toTarget, v, _t, volume, _loads);
+    }
+}
+} // namespace
+
+TEST_CASE("Workspace state is reset by a new query", "[SearchWorkspace]") {
+    SearchWorkspace<double, std::uint8_t> workspace(4);
+    // Go through several stamp wraparounds
+    for (int query = 0; query < 600; ++query) {
+        workspace.reset();
+        for (Graph::Node u = 0; u < 4; ++u) {
+            REQUIRE(!workspace.isTouched(u));
+            REQUIRE(workspace.getDistance(u)
+                    == std::numeric_limits<double>::max());
+            REQUIRE(workspace.getParent(u) == -1);
+        }
+        const Graph::Node u = query % 4;
+        workspace[u].distance = query;
+        workspace[u].parent = 0;
+        workspace[u].count = 2;
+        REQUIRE(workspace.isTouched(u));
+        REQUIRE(workspace.getDistance(u) == query);
+        REQUIRE(workspace.getCount(u) == 2);
+    }
+}
+
+TEST_CASE("Dijkstra distances match Bellman-Ford", "[ShortestPath]") {
+    for (unsigned int seed = 0; seed < 20; ++seed) {
+        const auto graph = getRandomGraph(30, 120, seed);
+        ShortestPath<DiGraph<double>> dijkstra(graph);
+        ShortestPathBellmanFord<DiGraph<double>> bellmanFord(graph);
+        bellmanFord.getShortestPath(0, 0);
+        for (Graph::Node t = 1; t < graph.getOrder(); ++t) {
+            const auto path = dijkstra.getShortestPath(0, t);
+            if (bellmanFord.getDistance(t)
+                == std::numeric_limits<double>::max()) {
+                REQUIRE(path.empty());
+            } else {
+                REQUIRE(dijkstra.getDistance(t) == bellmanFord.getDistance(t));
+            }
+        }
+    }
+}
+
+TEST_CASE("SPFA matches the pass based Bellman-Ford with negative weights",
+    "[ShortestPathBellmanFord]") {
+    for (unsigned int seed = 0; seed < 20; ++seed) {
+        // Node potentials create negative edges without changing the weight
+        // of the cycles
+        auto graph = getRandomGraph(30, 120, seed);
+        for (const auto& [u, v] : graph.getEdges()) {
+            graph.addEdgeWeight(u, v, 3.0 * (u - v));
+        }
+        ShortestPathBellmanFord<DiGraph<double>> spfa(graph);
+        ShortestPathBellmanFord<DiGraph<double>> passes(graph);
+        spfa.computeShortestPathTree(0);
+        for (Graph::Node t = 0; t < graph.getOrder(); ++t) {
+            passes.getShortestPath_v2(0, t);
+            REQUIRE(spfa.getDistance(t) == passes.getDistance(t));
+            const auto parent = spfa.getParent(t);
+            if (t != 0 && parent != -1) {
+                REQUIRE(
+                    spfa.getDistance(parent) + graph.getEdgeWeight(parent, t)
+                    == spfa.getDistance(t));
+            }
+        }
+    }
+}
+
+TEST_CASE(
+    "SPFA handles large integer distances", "[ShortestPathBellmanFord]") {
+    // The distances fit in an int, but not their sum over the queue
+    constexpr int order = 5000;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<Graph::Node> nodeDist(0, order - 1);
+    std::uniform_int_distribution<int> weightDist(100000, 1000000);
+    DiGraph<int> graph(order);
+    for (int i = 0; i < 5 * order; ++i) {
+        const auto u = nodeDist(gen);
+        const auto v = nodeDist(gen);
+        if (u != v) {
+            graph.addEdge(u, v, weightDist(gen));
+        }
+    }
+    ShortestPathBellmanFord<DiGraph<int>> spfa(graph);
+    ShortestPath<DiGraph<int>> dijkstra(graph);
+    spfa.computeShortestPathTree(0);
+    dijkstra.computeShortestPathTree(0);
+    for (Graph::Node t = 0; t < order; ++t) {
+        REQUIRE(spfa.getDistance(t) == dijkstra.getDistance(t));
+    }
+}
+
+TEST_CASE("SPFA detects negative cycles", "[ShortestPathBellmanFord]") {
+    DiGraph<double> graph(5);
+    graph.addEdge(0, 1, 1);
+    graph.addEdge(1, 2, 1);
+    graph.addEdge(2, 3, -1);
+    graph.addEdge(3, 1, -1);
+    graph.addEdge(3, 4, 1);
+    ShortestPathBellmanFord<DiGraph<double>> bellmanFord(graph);
+    REQUIRE_THROWS_AS(bellmanFord.getShortestPath(0, 4),
+        ShortestPathBellmanFord<DiGraph<double>>::NegativeCycleException);
+    Graph::Path cycle;
+    REQUIRE(bellmanFord.findNegativeCycle(0, cycle));
+    REQUIRE(cycle.size() == 4);
+    REQUIRE(cycle.front() == cycle.back());
+    // Same cycle up to a rotation
+    const auto start =
+        std::find(cycle.begin(), cycle.end() - 1, 1) - cycle.begin();
+    for (std::size_t i = 0; i < 3; ++i) {
+        REQUIRE(cycle[(start + i) % 3] == Graph::Node(i + 1));
+    }
+
+    graph.setEdgeWeight(3, 1, 0);
+    REQUIRE(!bellmanFord.findNegativeCycle(0, cycle));
+    REQUIRE(cycle.empty());
+    REQUIRE(bellmanFord.getShortestPath(0, 4) == Graph::Path{0, 1, 2, 3, 4});
+    REQUIRE(bellmanFord.getDistance(4) == 2);
+}
+
+TEST_CASE("Negative cycles found during the search are valid",
+    "[ShortestPathBellmanFord]") {
+    int nbCycles = 0;
+    for (unsigned int seed = 0; seed < 30; ++seed) {
+        auto graph = getRandomGraph(30, 90, seed);
+        for (const auto& [u, v] : graph.getEdges()) {
+            if ((u + v) % 9 == 0) {
+                graph.setEdgeWeight(u, v, -graph.getEdgeWeight(u, v));
+            }
+        }
+        ShortestPathBellmanFord<DiGraph<double>> bellmanFord(graph);
+        Graph::Path cycle;
+        if (bellmanFord.findNegativeCycle(0, cycle)) {
+            ++nbCycles;
+            REQUIRE(cycle.size() >= 2);
+            REQUIRE(cycle.front() == cycle.back());
+            double weight = 0;
+            for (std::size_t i = 1; i < cycle.size(); ++i) {
+                REQUIRE(graph.hasEdge(cycle[i - 1], cycle[i]));
+                weight += graph.getEdgeWeight(cycle[i - 1], cycle[i]);
+            }
+            REQUIRE(weight < 0);
+        } else {
+            // No negative cycle: the distances satisfy every edge
+            for (const auto& [u, v] : graph.getEdges()) {
+                if (bellmanFord.getParent(u) != -1) {
+                    REQUIRE(bellmanFord.getDistance(u)
+                                + graph.getEdgeWeight(u, v)
+                            >= bellmanFord.getDistance(v));
+                }
+            }
+        }
+    }
+    REQUIRE(nbCycles > 0);
+    REQUIRE(nbCycles < 30);
+}
+
+TEST_CASE("Vectorized edge relaxation matches the scalar loop",
+    "[EdgeRelaxation]") {
+    std::vector<RelaxationKernel> kernels{RelaxationKernel::Scalar};
+    const auto addKernel = [&](const RelaxationKernel _kernel) {
+        if (std::find(kernels.begin(), kernels.end(), _kernel)
+            == kernels.end()) {
+            kernels.push_back(_kernel);
+        }
+    };
+    addKernel(getBestRelaxationKernel<double>());
+    addKernel(getBestRelaxationKernel<int>());
+    // CPUs with AVX-512 also run the AVX2 kernel
+    if (getBestRelaxationKernel<double>() == RelaxationKernel::AVX512) {
+        addKernel(RelaxationKernel::AVX2);
+    }
+    for (unsigned int seed = 0; seed < 10; ++seed) {
+        auto graph = getRandomGraph(50, 600, seed);
+        for (const auto& [u, v] : graph.getEdges()) {
+            graph.addEdgeWeight(u, v, 3.0 * (u - v));
+        }
+        const auto doubleEdges = EdgeArrays<double>::fromGraph(graph);
+        EdgeArrays<int> intEdges;
+        for (std::size_t i = 0; i < doubleEdges.size(); ++i) {
+            intEdges.push_back(doubleEdges.src[i], doubleEdges.dst[i],
+                static_cast<int>(doubleEdges.weight[i]));
+        }
+        ShortestPathBellmanFord<DiGraph<double>> spfa(graph);
+        spfa.computeShortestPathTree(0);
+        for (const auto kernel : kernels) {
+            std::vector<double> doubleDistance(
+                50, std::numeric_limits<double>::max());
+            std::vector<int> intDistance(50, std::numeric_limits<int>::max());
+            std::vector<Graph::Node> parent(50, -1);
+            doubleDistance[0] = intDistance[0] = 0;
+            while (relaxEdges(doubleEdges, doubleDistance, parent, kernel)) {
+            }
+            if (kernel != RelaxationKernel::AVX512) {
+                while (relaxEdges(intEdges, intDistance, parent, kernel)) {
+                }
+            }
+            for (Graph::Node u = 0; u < 50; ++u) {
+                REQUIRE(doubleDistance[u] == spfa.getDistance(u));
+                if (kernel != RelaxationKernel::AVX512) {
+                    REQUIRE(intDistance[u] == spfa.getDistance(u));
+                }
+            }
+        }
+
+        ShortestPathBellmanFord<DiGraph<double>> sweeps(graph);
+        sweeps.computeShortestPathTreeBySweeps(0);
+        for (Graph::Node u = 0; u < 50; ++u) {
+            REQUIRE(sweeps.getDistance(u) == spfa.getDistance(u));
+        }
+        // Negative cycle 0 -> 1 -> 0 through the source
+        graph.addEdge(0, 1, -1000);
+        graph.addEdge(1, 0, 1);
+        using BellmanFord = ShortestPathBellmanFord<DiGraph<double>>;
+        REQUIRE_THROWS_AS(sweeps.computeShortestPathTreeBySweeps(0),
+            BellmanFord::NegativeCycleException);
+    }
+}
+
+TEST_CASE("Parallel Bellman-Ford matches SPFA", "[ParallelBellmanFord]") {
+    for (unsigned int seed = 0; seed < 20; ++seed) {
+        auto graph = getRandomGraph(60, 300, seed);
+        for (const auto& [u, v] : graph.getEdges()) {
+            graph.addEdgeWeight(u, v, 3.0 * (u % 7) - 3.0 * (v % 7));
+        }
+        if (seed % 2 == 1) {
+            // Likely creates a negative cycle
+            const auto& [u, v] = graph.getEdges()[seed];
+            graph.setEdgeWeight(u, v, -100);
+        }
+        ShortestPathBellmanFord<DiGraph<double>> spfa(graph);
+        Graph::Path expectedCycle;
+        const bool hasCycle = spfa.findNegativeCycle(0, expectedCycle);
+        for (const int nbThreads : {1, 2, 4}) {
+            ParallelBellmanFord<DiGraph<double>> bellmanFord(graph, nbThreads);
+            REQUIRE(bellmanFord.computeShortestPathTree(0) == !hasCycle);
+            if (hasCycle) {
+                const auto& cycle = bellmanFord.getNegativeCycle();
+                REQUIRE(cycle.front() == cycle.back());
+                double weight = 0;
+                for (std::size_t i = 1; i < cycle.size(); ++i) {
+                    weight += graph.getEdgeWeight(cycle[i - 1], cycle[i]);
+                }
+                REQUIRE(weight < 0);
+                continue;
+            }
+            REQUIRE(bellmanFord.getNegativeCycle().empty());
+            for (Graph::Node u = 0; u < graph.getOrder(); ++u) {
+                REQUIRE(bellmanFord.getDistance(u) == spfa.getDistance(u));
+                const auto parent = bellmanFord.getParent(u);
+                if (u != 0 && parent != -1) {
+                    REQUIRE(bellmanFord.getDistance(parent)
+                                + graph.getEdgeWeight(parent, u)
+                            == bellmanFord.getDistance(u));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Many-to-many distance tables") {
+    GIVEN("A random graph, a set of sources with duplicates and targets") {
+        const auto graph = getRandomGraph(40, 150, 42);
+        const std::vector<Graph::Node> sources{3, 0, 7, 3, 12, 0};
+        const std::vector<Graph::Node> targets{0, 5, 7, 21, 39};
+        ShortestPath<DiGraph<double>> shortestPath(graph);
+
+        WHEN("We compute the tables") {
+            ManyToManyShortestPath<DiGraph<double>> manyToMany(
+                graph, sources, targets);
+            manyToMany.computeDistances(true, 2);
+            THEN("Each entry matches a point-to-point query") {
+                for (std::size_t i = 0; i < sources.size(); ++i) {
+                    for (std::size_t j = 0; j < targets.size(); ++j) {
+                        const auto row = static_cast<int>(i);
+                        const auto column = static_cast<int>(j);
+                        const auto path = shortestPath.getShortestPath(
+                            sources[i], targets[j]);
+                        if (path.empty()) {
+                            REQUIRE(manyToMany.getDistance(row, column)
+                                    == std::numeric_limits<double>::max());
+                            REQUIRE(manyToMany.getFirstHop(row, column) == -1);
+                        } else {
+                            REQUIRE(manyToMany.getDistance(row, column)
+                                    == shortestPath.getDistance(targets[j]));
+                            const auto firstHop =
+                                manyToMany.getFirstHop(row, column);
+                            REQUIRE(graph.hasEdge(sources[i], firstHop)
+                                    == (sources[i] != targets[j]));
+                        }
+                    }
+                }
+            }
+        }
+        WHEN("We use the bucket algorithm on a flat hierarchy") {
+            ManyToManyShortestPath<DiGraph<double>> manyToMany(
+                graph, sources, targets);
+            manyToMany.computeDistances();
+            ManyToManyShortestPath<DiGraph<double>> bucketManyToMany(
+                graph, sources, targets);
+            bucketManyToMany.computeDistancesCH(
+                graph, graph.getReversedGraph(), 2);
+            THEN("We get the same distances") {
+                REQUIRE(
+                    manyToMany.getDistance() == bucketManyToMany.getDistance());
+            }
+        }
+    }
+}
+
+TEST_CASE("Johnson's all pairs shortest paths match SPFA",
+    "[AllShortestPathBellmanFord]") {
+    for (unsigned int seed = 0; seed < 10; ++seed) {
+        auto graph = getRandomGraph(40, 160, seed);
+        for (const auto& [u, v] : graph.getEdges()) {
+            graph.addEdgeWeight(u, v, 3.0 * (u - v));
+        }
+        AllShortestPathBellmanFord<DiGraph<double>> allPairs(graph);
+        REQUIRE(allPairs.getAllShortestPathsJohnson(seed % 4 + 1));
+        const auto& distance = allPairs.getDistance();
+        const auto& parent = allPairs.getParent();
+        ShortestPathBellmanFord<DiGraph<double>> spfa(graph);
+        for (Graph::Node s = 0; s < graph.getOrder(); ++s) {
+            spfa.computeShortestPathTree(s);
+            for (Graph::Node t = 0; t < graph.getOrder(); ++t) {
+                REQUIRE(distance(s, t) == spfa.getDistance(t));
+                if (t == s) {
+                    REQUIRE(parent(s, t) == s);
+                } else if (parent(s, t) != -1) {
+                    REQUIRE(distance(s, parent(s, t))
+                                + graph.getEdgeWeight(parent(s, t), t)
+                            == distance(s, t));
+                }
+            }
+        }
+    }
+
+    auto graph = getRandomGraph(10, 40, 0);
+    const auto& [u, v] = graph.getEdges().front();
+    graph.addEdge(v, u, -graph.getEdgeWeight(u, v) - 1);
+    AllShortestPathBellmanFord<DiGraph<double>> allPairs(graph);
+    REQUIRE(!allPairs.getAllShortestPathsJohnson());
+}
+
+TEST_CASE("All pairs paths and next hops follow the parent matrix",
+    "[AllShortestPathBellmanFord]") {
+    for (const int order : {40, 200}) {
+        auto graph = getRandomGraph(order, 3 * order, order);
+        AllShortestPathBellmanFord<DiGraph<double>> allPairs(graph);
+        REQUIRE(allPairs.getAllShortestPathsJohnson());
+        const auto& distance = allPairs.getDistance();
+        const auto nextHops = allPairs.getNextHops<int>();
+        const auto compactNextHops = allPairs.getCompactNextHops();
+        REQUIRE(compactNextHops.index() == (order <= 128 ? 0 : 1));
+        Graph::Path path;
+        for (Graph::Node s = 0; s < order; ++s) {
+            for (Graph::Node t = 0; t < order; ++t) {
+                const auto nextHop = allPairs.getNextHop(s, t);
+                REQUIRE(nextHops(s, t) == nextHop);
+                std::visit(
+                    [&](const auto& _nextHops) {
+                        REQUIRE(_nextHops(s, t) == nextHop);
+                    },
+                    compactNextHops);
+                if (!allPairs.getPath(s, t, path)) {
+                    REQUIRE(path.empty());
+                    REQUIRE(nextHop == -1);
+                    REQUIRE(distance(s, t)
+                            == std::numeric_limits<double>::max());
+                    continue;
+                }
+                REQUIRE(path.front() == s);
+                REQUIRE(path.back() == t);
+                REQUIRE(nextHop == (s == t ? s : path[1]));
+                double cost = 0;
+                for (std::size_t i = 1; i < path.size(); ++i) {
+                    cost += graph.getEdgeWeight(path[i - 1], path[i]);
+                }
+                REQUIRE(cost == distance(s, t));
+            }
+        }
+    }
+}
+
+TEST_CASE("Blocked Floyd-Warshall matches Johnson's algorithm",
+    "[FloydWarshall]") {
+    // Orders around the block size cover partial tiles
+    for (const int order : {1, 50, 64, 150}) {
+        auto graph = getRandomGraph(order, 4 * order, order);
+        for (const auto& [u, v] : graph.getEdges()) {
+            graph.addEdgeWeight(u, v, 3.0 * (u % 5) - 3.0 * (v % 5));
+        }
+        AllShortestPathBellmanFord<DiGraph<double>> johnson(graph);
+        REQUIRE(johnson.getAllShortestPathsJohnson());
+        for (const int nbThreads : {1, 4}) {
+            FloydWarshall<double> floydWarshall(graph);
+            REQUIRE(floydWarshall.computeAllShortestPaths(nbThreads));
+            FloydWarshall<std::int32_t> floydWarshallInt(graph);
+            REQUIRE(floydWarshallInt.computeAllShortestPaths(nbThreads));
+            for (Graph::Node s = 0; s < order; ++s) {
+                for (Graph::Node t = 0; t < order; ++t) {
+                    const auto distance = johnson.getDistance()(s, t);
+                    const auto nextHop = floydWarshall.getNextHop(s, t);
+                    if (distance == std::numeric_limits<double>::max()) {
+                        REQUIRE(floydWarshall.getDistance(s, t)
+                                == FloydWarshall<double>::infinity());
+                        REQUIRE(floydWarshallInt.getDistance(s, t)
+                                == FloydWarshall<std::int32_t>::infinity());
+                        REQUIRE(nextHop == -1);
+                        continue;
+                    }
+                    REQUIRE(floydWarshall.getDistance(s, t) == distance);
+                    REQUIRE(floydWarshallInt.getDistance(s, t) == distance);
+                    if (s == t) {
+                        REQUIRE(nextHop == s);
+                    } else {
+                        REQUIRE(graph.getEdgeWeight(s, nextHop)
+                                    + floydWarshall.getDistance(nextHop, t)
+                                == distance);
+                    }
+                }
+            }
+        }
+    }
+
+    auto graph = getRandomGraph(100, 400, 0);
+    const auto& [u, v] = graph.getEdges().front();
+    graph.addEdge(v, u, -graph.getEdgeWeight(u, v) - 1);
+    FloydWarshall<std::int32_t> floydWarshall(graph);
+    REQUIRE(!floydWarshall.computeAllShortestPaths());
+
+    // Strongly negative cycles: between every pair of nodes of one tile, and
+    // closed by the last node only, after long negative paths
+    DiGraph<int> complete(64);
+    DiGraph<int> ordered(150);
+    for (Graph::Node a = 0; a < 150; ++a) {
+        for (Graph::Node b = 0; b < 150; ++b) {
+            if (a < 64 && b < 64 && a != b) {
+                complete.addEdge(a, b, -1000);
+            }
+            if (a < b) {
+                ordered.addEdge(a, b, -1000);
+            }
+        }
+    }
+    ordered.addEdge(149, 0, 0);
+    for (const int nbThreads : {1, 4}) {
+        FloydWarshall<int> completeFloydWarshall(complete);
+        REQUIRE(!completeFloydWarshall.computeAllShortestPaths(nbThreads));
+        FloydWarshall<int> orderedFloydWarshall(ordered);
+        REQUIRE(!orderedFloydWarshall.computeAllShortestPaths(nbThreads));
+    }
+}
+
+TEST_CASE("LARAC returns a feasible path and a valid lower bound",
+    "[LagrangianShortestPath]") {
+    // Delays go against the costs, so the cheapest paths are slow
+    const auto delay = [](const Graph::Node _u, const Graph::Node _v) {
+        return static_cast<double>(11 - (_u * 7 + _v * 13) % 10);
+    };
+    int nbOptimal = 0;
+    for (unsigned int seed = 0; seed < 20; ++seed) {
+        const auto graph = getRandomGraph(12, 40, seed);
+        LagrangianShortestPath<DiGraph<double>> larac(graph);
+        const auto cost = [&](const Graph::Node _u, const Graph::Node _v) {
+            return graph.getEdgeWeight(_u, _v);
+        };
+        std::vector<char> onPath(graph.getOrder(), 0);
+        for (const double maxDelay : {8.0, 15.0, 25.0}) {
+            for (Graph::Node t = 1; t < graph.getOrder(); ++t) {
+                const double optimal = getBestConstrainedCost(
+                    graph, 0, t, 0.0, 0.0, maxDelay, delay, onPath);
+                const bool isFeasible =
+                    optimal != std::numeric_limits<double>::infinity();
+                REQUIRE(larac.solve(0, t, maxDelay, cost, delay)
+                        == isFeasible);
+                if (!isFeasible) {
+                    continue;
+                }
+                const auto& path = larac.getPath();
+                REQUIRE(path.front() == 0);
+                REQUIRE(path.back() == t);
+                double pathCost = 0.0;
+                double pathDelay = 0.0;
+                for (std::size_t i = 1; i < path.size(); ++i) {
+                    pathCost += cost(path[i - 1], path[i]);
+                    pathDelay += delay(path[i - 1], path[i]);
+                }
+                REQUIRE(pathCost == larac.getCost());
+                REQUIRE(pathDelay == larac.getDelay());
+                REQUIRE(pathDelay <= maxDelay);
+                REQUIRE(larac.getCost() >= optimal);
+                REQUIRE(larac.getLowerBound() <= optimal + 1e-9);
+                REQUIRE(larac.getGap() >= -1e-9);
+                nbOptimal += larac.getCost() == optimal ? 1 : 0;
+            }
+        }
+    }
+    REQUIRE(nbOptimal > 0);
+}
+
+TEST_CASE("Disjoint paths match an enumeration of path pairs",
+    "[DisjointShortestPaths]") {
+    using Solver = DisjointShortestPaths<DiGraph<double>>;
+    for (unsigned int seed = 0; seed < 20; ++seed) {
+        const auto graph = getRandomGraph(9, 30, seed);
+        for (const auto disjointness :
+            {Solver::Disjointness::Edge, Solver::Disjointness::Node}) {
+            const bool nodeDisjoint =
+                disjointness == Solver::Disjointness::Node;
+            Solver solver(graph, disjointness);
+            std::vector<Solver::Demand> demands;
+            for (Graph::Node t = 1; t < graph.getOrder(); ++t) {
+                demands.push_back({0, t});
+                Graph::Path path;
+                std::vector<Graph::Path> simplePaths;
+                getSimplePaths(graph, 0, t, path, simplePaths);
+                std::vector<double> weights;
+                for (const auto& simplePath : simplePaths) {
+                    weights.push_back(0.0);
+                    for (std::size_t i = 1; i < simplePath.size(); ++i) {
+                        weights.back() += graph.getEdgeWeight(
+                            simplePath[i - 1], simplePath[i]);
+                    }
+                }
+                double bestPair = std::numeric_limits<double>::infinity();
+                for (std::size_t i = 0; i < simplePaths.size(); ++i) {
+                    for (std::size_t j = i + 1; j < simplePaths.size(); ++j) {
+                        if (areDisjoint(simplePaths[i], simplePaths[j],
+                                nodeDisjoint)) {
+                            bestPair =
+                                std::min(bestPair, weights[i] + weights[j]);
+                        }
+                    }
+                }
+
+                const int nbPaths = solver.computeDisjointPaths(0, t, 3);
+                const auto& paths = solver.getPaths();
+                REQUIRE(paths.size() == static_cast<std::size_t>(nbPaths));
+                const bool hasPair =
+                    bestPair != std::numeric_limits<double>::infinity();
+                REQUIRE((nbPaths >= 2) == hasPair);
+                for (int i = 0; i < nbPaths; ++i) {
+                    REQUIRE(paths[i].front() == 0);
+                    REQUIRE(paths[i].back() == t);
+                    double weight = 0.0;
+                    for (std::size_t j = 1; j < paths[i].size(); ++j) {
+                        REQUIRE(graph.hasEdge(paths[i][j - 1], paths[i][j]));
+                        weight += graph.getEdgeWeight(
+                            paths[i][j - 1], paths[i][j]);
+                    }
+                    REQUIRE(weight == solver.getWeight(i));
+                    for (int j = 0; j < i; ++j) {
+                        REQUIRE(solver.getWeight(j) <= solver.getWeight(i));
+                        REQUIRE(areDisjoint(paths[i], paths[j], nodeDisjoint));
+                    }
+                }
+                if (nbPaths >= 2 && solver.computeDisjointPaths(0, t) == 2) {
+                    REQUIRE(solver.getTotalWeight() == bestPair);
+                }
+            }
+
+            std::vector<PathArena> batchPaths;
+            std::vector<double> batchWeights;
+            solver.computeDisjointPaths(
+                demands, 2, batchPaths, batchWeights, 3);
+            for (std::size_t i = 0; i < demands.size(); ++i) {
+                solver.computeDisjointPaths(
+                    demands[i].source, demands[i].target);
+                REQUIRE(batchWeights[i] == solver.getTotalWeight());
+                REQUIRE(batchPaths[i].size() == solver.getPaths().size());
+                for (std::size_t j = 0; j < batchPaths[i].size(); ++j) {
+                    REQUIRE(std::ranges::equal(
+                        batchPaths[i][j], solver.getPaths()[j]));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Shortest path DAG counts and splits the equal cost paths",
+    "[ShortestPathDag]") {
+    using Dag = ShortestPathDag<DiGraph<double>>;
+    for (unsigned int seed = 0; seed < 10; ++seed) {
+        // Few distinct weights make many equal cost paths
+        auto graph = getRandomGraph(10, 40, seed);
+        for (const auto& [u, v] : graph.getEdges()) {
+            graph.setEdgeWeight(u, v, 1.0 + (u + v) % 2);
+        }
+        const auto reversed = graph.getReversedGraph();
+        Dag dag(graph);
+        std::vector<Dag::Demand> demands;
+        Matrix<double> expectedLoads(graph.getOrder(), graph.getOrder(), 0.0);
+        std::vector<char> onPath(graph.getOrder(), 0);
+        for (Graph::Node s = 0; s < graph.getOrder(); s += 3) {
+            dag.computeShortestPathDag(s);
+            REQUIRE(dag.getRoot() == s);
+            for (Graph::Node t = 0; t < graph.getOrder(); ++t) {
+                std::vector<double> costs;
+                getSimplePathCosts(graph, s, t, 0.0, onPath, costs);
+                if (costs.empty()) {
+                    REQUIRE(dag.getNbPaths(t) == 0.0);
+                    continue;
+                }
+                const double distance =
+                    *std::min_element(costs.begin(), costs.end());
+                REQUIRE(dag.getDistance(t) == distance);
+                REQUIRE(dag.getNbPaths(t)
+                        == static_cast<double>(
+                            std::count(costs.begin(), costs.end(), distance)));
+                for (const auto u : dag.getPredecessors(t)) {
+                    REQUIRE(dag.getDistance(u) + graph.getEdgeWeight(u, t)
+                            == distance);
+                }
+                if (t == s) {
+                    continue;
+                }
+
+                const double volume = 1.0 + t;
+                demands.push_back({s, t, volume});
+                ShortestPath<DiGraph<double>> toTarget(reversed);
+                toTarget.computeShortestPathTree(t);
+                routeEcmp(graph, toTarget, s, t, volume, expectedLoads);
+
+                Matrix<double> loads(graph.getOrder(), graph.getOrder(), 0.0);
+                REQUIRE(dag.addEcmpLoads(t, volume, loads));
+                double outOfSource = 0.0;
+                for (const auto v : graph.getNeighbors(s)) {
+                    outOfSource += loads(s, v);
+                }
+                REQUIRE(outOfSource == Approx(volume));
+            }
+        }
+
+        Matrix<double> loads(graph.getOrder(), graph.getOrder(), -1.0);
+        dag.computeEcmpLoads(demands, loads, 3);
+        for (Graph::Node u = 0; u < graph.getOrder(); ++u) {
+            for (Graph::Node v = 0; v < graph.getOrder(); ++v) {
+                REQUIRE(loads(u, v) == Approx(expectedLoads(u, v)));
+            }
+        }
+    }
+}
+
+TEST_CASE("Early terminating searches only settle the nodes they need",
+    "[ShortestPath]") {
+    const auto graph = getRandomGraph(300, 1500, 11);
+    ShortestPath<DiGraph<double>> full(graph);
+    full.computeShortestPathTree(0);
+    ShortestPath<DiGraph<double>> bounded(graph);
+
+    for (const double bound : {0.0, 5.0, 12.0, 1000.0}) {
+        bounded.computeShortestPathTreeWithin(0, bound);
+        std::size_t nbWithin = 0;
+        for (Graph::Node u = 0; u < graph.getOrder(); ++u) {
+            nbWithin += full.getDistance(u) <= bound ? 1 : 0;
+            REQUIRE(bounded.isSettled(u) == (full.getDistance(u) <= bound));
+        }
+        REQUIRE(bounded.getSettledNodes().size() == nbWithin);
+        for (const auto u : bounded.getSettledNodes()) {
+            REQUIRE(bounded.getDistance(u) == full.getDistance(u));
+            REQUIRE(bounded.getParent(u) != -1);
+        }
+    }
+
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<Graph::Node> nodeDist(1, 299);
+    for (int i = 0; i < 20; ++i) {
+        std::vector<Graph::Node> targets(1 + i % 5);
+        for (auto& t : targets) {
+            t = nodeDist(gen);
+        }
+        // Duplicates are counted once
+        targets.push_back(targets.front());
+        double farthest = 0.0;
+        int nbDistinct = 0;
+        int nbReachable = 0;
+        for (std::size_t j = 0; j + 1 < targets.size(); ++j) {
+            const auto t = targets[j];
+            if (std::find(targets.begin(), targets.begin() + j, t)
+                == targets.begin() + j) {
+                ++nbDistinct;
+                if (full.isSettled(t)) {
+                    farthest = std::max(farthest, full.getDistance(t));
+                    ++nbReachable;
+                }
+            }
+        }
+        REQUIRE(bounded.computeShortestPathsToTargets(0, targets)
+                == nbReachable);
+        for (const auto t : targets) {
+            REQUIRE(bounded.isSettled(t) == full.isSettled(t));
+        }
+        for (const auto u : bounded.getSettledNodes()) {
+            REQUIRE(bounded.getDistance(u) == full.getDistance(u));
+            // An unreachable target makes the search explore everything
+            if (nbReachable == nbDistinct) {
+                REQUIRE(bounded.getDistance(u) <= farthest);
+            }
+        }
+
+        // A bound below the farthest target leaves it unsettled
+        if (nbReachable > 0) {
+            const int nbWithin = bounded.computeShortestPathsToTargets(
+                0, targets, farthest - 0.5);
+            REQUIRE(nbWithin < nbReachable);
+            for (const auto u : bounded.getSettledNodes()) {
+                REQUIRE(bounded.getDistance(u) <= farthest - 0.5);
+            }
+        }
+    }
+    REQUIRE(bounded.computeShortestPathsToTargets(0, {}) == 0);
+    REQUIRE(bounded.getSettledNodes().empty());
+}
+
+TEST_CASE("DAG shortest and longest paths match Bellman-Ford",
+    "[AcyclicShortestPath]") {
+    for (unsigned int seed = 0; seed < 10; ++seed) {
+        // Edges follow a random order of the nodes, with any sign
+        std::mt19937 gen(seed);
+        std::vector<Graph::Node> rank(60);
+        std::iota(rank.begin(), rank.end(), 0);
+        std::shuffle(rank.begin(), rank.end(), gen);
+        std::uniform_int_distribution<Graph::Node> nodeDist(0, 59);
+        std::uniform_int_distribution<int> weightDist(-5, 10);
+        DiGraph<double> graph(60);
+        DiGraph<double> negated(60);
+        for (int i = 0; i < 300; ++i) {
+            const auto u = nodeDist(gen);
+            const auto v = nodeDist(gen);
+            if (rank[u] < rank[v]) {
+                const double weight = weightDist(gen);
+                graph.addEdge(u, v, weight);
+                negated.addEdge(u, v, -weight);
+            }
+        }
+
+        AcyclicShortestPath<DiGraph<double>> shortest(graph);
+        AcyclicShortestPath<DiGraph<double>, std::greater<double>> longest(
+            graph);
+        REQUIRE(shortest.isAcyclic());
+        const auto& order = shortest.getTopologicalOrder();
+        std::vector<int> positions(graph.getOrder());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            positions[order[i]] = static_cast<int>(i);
+        }
+        for (const auto& [u, v] : graph.getEdges()) {
+            REQUIRE(positions[u] < positions[v]);
+        }
+
+        ShortestPathBellmanFord<DiGraph<double>> bellmanFord(graph);
+        ShortestPathBellmanFord<DiGraph<double>> longestBellmanFord(negated);
+        std::vector<Graph::Node> sources;
+        Graph::Path path;
+        for (Graph::Node s = 0; s < graph.getOrder(); s += 7) {
+            sources.push_back(s);
+            shortest.computeShortestPathTree(s);
+            longest.computeShortestPathTree(s);
+            bellmanFord.computeShortestPathTree(s);
+            longestBellmanFord.computeShortestPathTree(s);
+            for (Graph::Node t = 0; t < graph.getOrder(); ++t) {
+                if (bellmanFord.getParent(t) == -1) {
+                    REQUIRE(shortest.getDistance(t)
+                            == shortest.getUnreachedDistance());
+                    REQUIRE(longest.getDistance(t)
+                            == longest.getUnreachedDistance());
+                    REQUIRE(!shortest.getPath(t, path));
+                    continue;
+                }
+                REQUIRE(shortest.getDistance(t) == bellmanFord.getDistance(t));
+                REQUIRE(longest.getDistance(t)
+                        == -longestBellmanFord.getDistance(t));
+                REQUIRE(longest.getPath(t, path));
+                REQUIRE(path.front() == s);
+                REQUIRE(path.back() == t);
+                double weight = 0.0;
+                for (std::size_t i = 1; i < path.size(); ++i) {
+                    weight += graph.getEdgeWeight(path[i - 1], path[i]);
+                }
+                REQUIRE(weight == longest.getDistance(t));
+            }
+        }
+
+        shortest.computeDistances(sources);
+        longest.computeDistances(sources);
+        for (std::size_t i = 0; i < sources.size(); ++i) {
+            AcyclicShortestPath<DiGraph<double>> single(graph);
+            single.computeShortestPathTree(sources[i]);
+            for (Graph::Node t = 0; t < graph.getOrder(); ++t) {
+                REQUIRE(shortest.getDistance(i, t) == single.getDistance(t));
+            }
+            longest.computeShortestPathTree(sources[i]);
+            for (Graph::Node t = 0; t < graph.getOrder(); ++t) {
+                REQUIRE(longest.getDistance(i, t) == longest.getDistance(t));
+            }
+        }
+    }
+
+    DiGraph<int> cycle(3);
+    cycle.addEdge(0, 1, 1);
+    cycle.addEdge(1, 2, 1);
+    cycle.addEdge(2, 1, 1);
+    REQUIRE(!AcyclicShortestPath<DiGraph<int>>(cycle).isAcyclic());
+}
+
+TEST_CASE("Delta-stepping matches Dijkstra", "[DeltaStepping]") {
+    const auto graph = getRandomGraph(200, 1000, 7);
+    ShortestPath<DiGraph<double>> dijkstra(graph);
+    dijkstra.computeShortestPathTree(0);
+
+    DeltaStepping<DiGraph<double>> reference(graph, 3.0, 1);
+    reference.computeShortestPathTree(0);
+    for (const double delta : {0.5, 3.0, 100.0}) {
+        for (const int nbThreads : {1, 2, 4}) {
+            DeltaStepping<DiGraph<double>> deltaStepping(
+                graph, delta, nbThreads);
+            deltaStepping.computeShortestPathTree(0);
+            for (Graph::Node u = 0; u < graph.getOrder(); ++u) {
+                REQUIRE(
+                    deltaStepping.getDistance(u) == dijkstra.getDistance(u));
+            }
+            REQUIRE(deltaStepping.getParents() == reference.getParents());
+        }
+    }
+}
+
+SCENARIO("Shortest paths written into caller buffers") {
+    GIVEN("A random graph and a reused path buffer") {
+        const auto graph = getRandomGraph(50, 200, 3);
+        ShortestPath<DiGraph<double>> shortestPath(graph);
+        Graph::Path buffer;
+        WHEN("We query every target from node 0") {
+            THEN("The buffer, the view and the returned path agree") {
+                for (Graph::Node t = 0; t < graph.getOrder(); ++t) {
+                    const auto path = shortestPath.getShortestPath(0, t);
+                    REQUIRE(shortestPath.getShortestPath(0, t, buffer)
+                            == !path.empty());
+                    REQUIRE(buffer == path);
+                    const auto view = shortestPath.getReversedPath(t);
+                    REQUIRE(view.size() == path.size());
+                    REQUIRE(std::equal(
+                        view.begin(), view.end(), path.rbegin(), path.rend()));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Paths stored in an arena", "[PathArena]") {
+    PathArena arena;
+    const Graph::Path path1{0, 1, 2};
+    const Graph::Path path2{0, 3};
+    REQUIRE(arena.push(path1.begin(), path1.end()) == 0);
+    REQUIRE(arena.push(path2.begin(), path2.end()) == 1);
+    arena.appendPrefix(0, 2);
+    arena.append(4);
+    REQUIRE(arena.closePath() == 2);
+
+    REQUIRE(arena.size() == 3);
+    REQUIRE(Graph::Path(arena[0].begin(), arena[0].end()) == path1);
+    REQUIRE(Graph::Path(arena[1].begin(), arena[1].end()) == path2);
+    REQUIRE(Graph::Path(arena.back().begin(), arena.back().end())
+            == Graph::Path{0, 1, 4});
+
+    arena.clear();
+    REQUIRE(arena.empty());
+}
+
+SCENARIO("K shortest paths in number of arcs") {
+    GIVEN("A graph with three disjoint paths from 0 to 5") {
+        DiGraph<double> graph(6);
+        graph.addEdge(0, 5);
+        graph.addEdge(0, 1);
+        graph.addEdge(1, 5);
+        graph.addEdge(0, 2);
+        graph.addEdge(2, 3);
+        graph.addEdge(3, 5);
+        ShortestPath<DiGraph<double>> shortestPath(graph);
+        WHEN("We ask for 5 paths") {
+            PathArena paths;
+            shortestPath.getKShortestPath(0, 5, 5, paths);
+            THEN("We get the three paths by increasing size") {
+                REQUIRE(paths.size() == 3);
+                REQUIRE(paths[0].size() == 2);
+                REQUIRE(paths[1].size() == 3);
+                REQUIRE(paths[2].size() == 4);
+                REQUIRE(shortestPath.getKShortestPath(0, 5, 5).size() == 3);
+            }
+        }
+    }
+}
+
+TEST_CASE("Weighted K shortest paths match an enumeration of simple paths",
+    "[ShortestPath]") {
+    for (unsigned int seed = 0; seed < 20; ++seed) {
+        const auto graph = getRandomGraph(8, 24, seed);
+        std::vector<char> onPath(8, 0);
+        std::vector<double> expected;
+        getSimplePathCosts(graph, 0, 7, 0, onPath, expected);
+        std::sort(expected.begin(), expected.end());
+        expected.resize(std::min<std::size_t>(expected.size(), 15));
+
+        ShortestPath<DiGraph<double>> shortestPath(graph);
+        PathArena paths;
+        std::vector<double> costs;
+        shortestPath.getKShortestPath(0, 7, 15, paths, costs);
+        REQUIRE(costs == expected);
+        REQUIRE(paths.size() == costs.size());
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            const auto path = paths[i];
+            REQUIRE(path.front() == 0);
+            REQUIRE(path.back() == 7);
+            double cost = 0;
+            for (std::size_t j = 1; j < path.size(); ++j) {
+                cost += graph.getEdgeWeight(path[j - 1], path[j]);
+            }
+            REQUIRE(cost == costs[i]);
+            for (std::size_t j = 0; j < i; ++j) {
+                REQUIRE(!std::equal(path.begin(), path.end(), paths[j].begin(),
+                    paths[j].end()));
+            }
+        }
+    }
+}
+
+TEST_CASE("Parallel K shortest paths do not depend on the number of threads",
+    "[ShortestPath]") {
+    for (unsigned int seed = 0; seed < 10; ++seed) {
+        const auto graph = getRandomGraph(30, 150, seed);
+        ShortestPath<DiGraph<double>> shortestPath(graph);
+        PathArena expectedPaths;
+        std::vector<double> expectedCosts;
+        shortestPath.getKShortestPath(0, 29, 20, expectedPaths, expectedCosts);
+        for (const int nbThreads : {1, 2, 4}) {
+            PathArena paths;
+            std::vector<double> costs;
+            shortestPath.getKShortestPathParallel(
+                0, 29, 20, paths, costs, nbThreads);
+            REQUIRE(costs == expectedCosts);
+            REQUIRE(paths.size() == expectedPaths.size());
+            for (std::size_t i = 0; i < paths.size(); ++i) {
+                REQUIRE(std::equal(paths[i].begin(), paths[i].end(),
+                    expectedPaths[i].begin(), expectedPaths[i].end()));
+            }
+        }
+    }
+}
+
+TEST_CASE("Lazy enumeration of the K shortest walks", "[KShortestWalks]") {
+    for (unsigned int seed = 0; seed < 10; ++seed) {
+        const auto graph = getRandomGraph(6, 15, seed);
+        KShortestWalks<DiGraph<double>> walks(graph, 0);
+        // Stop after 30 walks
+        std::vector<double> costs;
+        std::vector<Graph::Path> paths;
+        for (const auto& walk : walks.getWalks(5)) {
+            costs.push_back(walk.cost);
+            paths.push_back(walk.path);
+            if (costs.size() == 30) {
+                break;
+            }
+        }
+        REQUIRE(walks.getNbWalks(5) == costs.size());
+
+        std::vector<double> expected;
+        if (!costs.empty()) {
+            getWalkCosts(graph, 0, 5, 0, costs.back(), expected);
+            std::sort(expected.begin(), expected.end());
+            expected.resize(costs.size());
+        }
+        REQUIRE(costs == expected);
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            const auto& path = paths[i];
+            REQUIRE(path.front() == 0);
+            REQUIRE(path.back() == 5);
+            double cost = 0;
+            for (std::size_t j = 1; j < path.size(); ++j) {
+                cost += graph.getEdgeWeight(path[j - 1], path[j]);
+            }
+            REQUIRE(cost == costs[i]);
+            REQUIRE(std::count(paths.begin(), paths.end(), path) == 1);
+        }
+    }
+}
+
+TEST_CASE("Dynamic shortest paths match a recomputation",
+    "[DynamicShortestPath]") {
+    auto graph = getRandomGraph(40, 200, 3);
+    const auto edges = graph.getEdges();
+    DynamicShortestPath<DiGraph<double>> dynamic(graph, 0);
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> edgeDist(0, edges.size() - 1);
+    std::uniform_int_distribution<int> weightDist(-3, 3);
+    for (int batch = 0; batch < 50; ++batch) {
+        for (int i = 0; i < 5; ++i) {
+            const auto& [u, v] = edges[edgeDist(gen)];
+            const double delta = weightDist(gen);
+            if (graph.getEdgeWeight(u, v) + delta >= 0) {
+                dynamic.addEdgeWeight(u, v, delta);
+            } else {
+                dynamic.setEdgeWeight(u, v, 0);
+            }
+        }
+        const int nbTouched = dynamic.update();
+        REQUIRE(nbTouched == dynamic.getNbTouchedNodes());
+
+        ShortestPath<DiGraph<double>> shortestPath(graph);
+        shortestPath.computeShortestPathTree(0);
+        for (Graph::Node u = 0; u < graph.getOrder(); ++u) {
+            REQUIRE(dynamic.getDistance(u) == shortestPath.getDistance(u));
+            const auto parent = dynamic.getParent(u);
+            if (u != 0 && parent != -1) {
+                REQUIRE(dynamic.getDistance(parent)
+                            + graph.getEdgeWeight(parent, u)
+                        == dynamic.getDistance(u));
+            }
+        }
+    }
+}
+
+TEST_CASE("Dynamic shortest path updates only touch the affected nodes",
+    "[DynamicShortestPath]") {
+    auto graph = getRandomGraph(60, 300, 5);
+    DynamicShortestPath<DiGraph<double>> dynamic(graph, 0);
+    // Nodes of the subtree rooted at _v, by walking up the parents
+    const auto getSubtree = [&](const Graph::Node _v) {
+        std::vector<Graph::Node> subtree;
+        for (Graph::Node u = 0; u < graph.getOrder(); ++u) {
+            for (Graph::Node w = u; dynamic.getParent(w) != -1;
+                 w = dynamic.getParent(w)) {
+                if (w == _v) {
+                    subtree.push_back(u);
+                    break;
+                }
+                if (w == 0) {
+                    break;
+                }
+            }
+        }
+        return subtree;
+    };
+    const auto getSortedTouched = [&] {
+        auto touched = dynamic.getTouchedNodes();
+        std::sort(touched.begin(), touched.end());
+        return touched;
+    };
+
+    int nbTreeEdges = 0;
+    int nbNonTreeEdges = 0;
+    for (const auto& [u, v] : graph.getEdges()) {
+        if (dynamic.getParent(u) == -1) {
+            continue;
+        }
+        std::vector<double> before(graph.getOrder());
+        for (Graph::Node w = 0; w < graph.getOrder(); ++w) {
+            before[w] = dynamic.getDistance(w);
+        }
+        const auto getChanged = [&] {
+            std::vector<Graph::Node> changed;
+            for (Graph::Node w = 0; w < graph.getOrder(); ++w) {
+                if (dynamic.getDistance(w) != before[w]) {
+                    changed.push_back(w);
+                }
+            }
+            return changed;
+        };
+
+        if (dynamic.getParent(v) != u) {
+            // A heavier edge out of the tree changes nothing
+            ++nbNonTreeEdges;
+            dynamic.addEdgeWeight(u, v, 5.0);
+            REQUIRE(dynamic.update() == 0);
+            dynamic.addEdgeWeight(u, v, -5.0);
+            REQUIRE(dynamic.update() == 0);
+            continue;
+        }
+        ++nbTreeEdges;
+        // A heavier tree edge touches exactly its subtree, which contains
+        // every node whose distance changed
+        const auto subtree = getSubtree(v);
+        dynamic.addEdgeWeight(u, v, 5.0);
+        dynamic.update();
+        REQUIRE(getSortedTouched() == subtree);
+        const auto changed = getChanged();
+        REQUIRE(std::includes(subtree.begin(), subtree.end(), changed.begin(),
+            changed.end()));
+
+        // Restoring the weight touches exactly the nodes that get closer
+        for (Graph::Node w = 0; w < graph.getOrder(); ++w) {
+            before[w] = dynamic.getDistance(w);
+        }
+        dynamic.addEdgeWeight(u, v, -5.0);
+        dynamic.update();
+        REQUIRE(getSortedTouched() == getChanged());
+
+        ShortestPath<DiGraph<double>> shortestPath(graph);
+        shortestPath.computeShortestPathTree(0);
+        for (Graph::Node w = 0; w < graph.getOrder(); ++w) {
+            REQUIRE(dynamic.getDistance(w) == shortestPath.getDistance(w));
+        }
+    }
+    REQUIRE(nbTreeEdges > 0);
+    REQUIRE(nbNonTreeEdges > 0);
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
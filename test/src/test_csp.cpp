@@ -1,8 +1,88 @@
 #include <CppRO/ConstrainedShortestPath.hpp>
+#include <CppRO/ConstrainedShortestPathBatch.hpp>
+#include <CppRO/ConstrainedShortestPathLabeling.hpp>
+#include <CppRO/ConstrainedShortestPathPulse.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/graph_selectors.hpp>
 #include <catch2/catch.hpp>
+#include <limits>
 #include <numeric>
+#include <random>
+
+namespace {
+using CspGraph = boost::adjacency_list<boost::vecS, boost::vecS,
+    boost::bidirectionalS, boost::no_property,
+    boost::property<boost::edge_index_t, std::size_t>, boost::no_property,
+    boost::vecS>;
+
+/**
+ * Network of the ILP scenario: A-B-C is expensive and fast, A-D-E-C and
+ * A-D-E-F-C are cheap and slow
+ */
+CspGraph getScenarioGraph() {
+    const std::vector<std::pair<std::size_t, std::size_t>> edgeList{
+        {0, 1}, {1, 2}, {0, 3}, {3, 4}, {4, 2}, {4, 5}, {5, 2}};
+    const std::vector<std::size_t> edgeIndex{0, 1, 2, 3, 4, 5, 6};
+    return CspGraph(edgeList.begin(), edgeList.end(), edgeIndex.begin(), 6);
+}
+
+const std::vector<std::size_t> SCENARIO_DELAYS{50, 50, 100, 100, 60, 50, 100};
+const std::vector<double> SCENARIO_COSTS{10.0, 10.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+
+CspGraph getRandomCspGraph(const std::size_t _order,
+    const std::size_t _nbEdges, std::mt19937& _gen) {
+    std::uniform_int_distribution<std::size_t> nodeDist(0, _order - 1);
+    std::vector<std::pair<std::size_t, std::size_t>> edgeList;
+    while (edgeList.size() < _nbEdges) {
+        const auto u = nodeDist(_gen);
+        const auto v = nodeDist(_gen);
+        if (u != v) {
+            edgeList.emplace_back(u, v);
+        }
+    }
+    std::vector<std::size_t> edgeIndex(_nbEdges);
+    std::iota(edgeIndex.begin(), edgeIndex.end(), 0);
+    return CspGraph(
+        edgeList.begin(), edgeList.end(), edgeIndex.begin(), _order);
+}
+
+/**
+ * Cost of the cheapest simple path from _u to _t within _maxResources, by
+ * enumeration
+ */
+template <std::size_t NbResources>
+double getBestPathCost(
+    const CppRO::ConstrainedShortestPathNetwork<NbResources>& _network,
+    const std::size_t _u, const std::size_t _t, const double _cost,
+    const std::array<double, NbResources>& _resources,
+    const std::array<double, NbResources>& _maxResources,
+    std::vector<char>& _onPath) {
+    for (std::size_t r = 0; r < NbResources; ++r) {
+        if (_resources[r] > _maxResources[r]) {
+            return std::numeric_limits<double>::infinity();
+        }
+    }
+    if (_u == _t) {
+        return _cost;
+    }
+    double best = std::numeric_limits<double>::infinity();
+    _onPath[_u] = 1;
+    for (const auto& arc : _network.getOutArcs(_u)) {
+        if (!_onPath[arc.node]) {
+            auto resources = _resources;
+            for (std::size_t r = 0; r < NbResources; ++r) {
+                resources[r] += _network.getResources(arc.edge)[r];
+            }
+            best = std::min(best,
+                getBestPathCost(_network, arc.node, _t,
+                    _cost + _network.getCost(arc.edge), resources,
+                    _maxResources, _onPath));
+        }
+    }
+    _onPath[_u] = 0;
+    return best;
+}
+} // namespace
 
 SCENARIO("ILP model returns optimal solution") {
     GIVEN("A network") {
@@ -104,3 +184,284 @@ SCENARIO("ILP model returns optimal solution") {
         }
     }
 }
+
+SCENARIO("ILP model updates only the changed coefficients") {
+    GIVEN("The ILP model of the scenario with its own objective") {
+        constexpr auto A = 0;
+        constexpr auto C = 2;
+        const auto graph = getScenarioGraph();
+
+        IloEnvWrapper env;
+        CppRO::CompactConstrainedShortestPathModel cspModel(
+            env, graph, get(boost::edge_index, graph));
+        REQUIRE(cspModel.setDelays(SCENARIO_DELAYS) == 7);
+        REQUIRE(cspModel.setCosts(SCENARIO_COSTS) == 7);
+        cspModel.setNodePair(A, C);
+        cspModel.setMaxDelay(300);
+        IloCplex solver(cspModel.getModel());
+        REQUIRE(solver.solve() == IloTrue);
+        REQUIRE(epsilon_equal<double>()(solver.getObjValue(), 3.0));
+
+        WHEN("We set the same costs and delays again") {
+            THEN("No coefficient is updated") {
+                REQUIRE(cspModel.setDelays(SCENARIO_DELAYS) == 0);
+                REQUIRE(cspModel.setCosts(SCENARIO_COSTS) == 0);
+            }
+        }
+        WHEN("We make the edge (E, C) expensive") {
+            const std::vector<std::size_t> changedEdges{0, 4};
+            const std::vector<double> changedCosts{10.0, 20.0};
+            THEN("Only its cost is updated and (A, B, C) is optimal") {
+                REQUIRE(cspModel.setCosts(changedEdges, changedCosts) == 1);
+                REQUIRE(solver.solve() == IloTrue);
+                REQUIRE(epsilon_equal<double>()(solver.getObjValue(), 20.0));
+                REQUIRE(solver.getValue(cspModel.getFlowVars()[0]) == IloTrue);
+            }
+        }
+        WHEN("We make the edge (E, C) slow") {
+            cspModel.setDelay(4, 200.0);
+            THEN("(A, D, E, F, C) is optimal with at most 399ms") {
+                cspModel.setMaxDelay(400);
+                REQUIRE(solver.solve() == IloTrue);
+                REQUIRE(epsilon_equal<double>()(solver.getObjValue(), 3.0));
+                cspModel.setMaxDelay(399);
+                REQUIRE(solver.solve() == IloTrue);
+                REQUIRE(epsilon_equal<double>()(solver.getObjValue(), 4.0));
+                REQUIRE(solver.getValue(cspModel.getFlowVars()[6]) == IloTrue);
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("Exact CSP engines return the same paths as the ILP model",
+    "", CppRO::LabelingConstrainedShortestPath<>,
+    CppRO::BidirectionalLabelingConstrainedShortestPath<>,
+    CppRO::PulseConstrainedShortestPath<>) {
+    GIVEN("The network of the ILP scenario") {
+        constexpr auto A = 0;
+        constexpr auto B = 1;
+        constexpr auto C = 2;
+        constexpr auto D = 3;
+        constexpr auto E = 4;
+        const auto testGraph = getScenarioGraph();
+        CppRO::ConstrainedShortestPathNetwork<> network(
+            testGraph, get(boost::edge_index, testGraph));
+        network.setDelays(SCENARIO_DELAYS);
+        network.setCosts(SCENARIO_COSTS);
+        TestType engine(network);
+        engine.setNodePair(A, C);
+
+        WHEN("We search for the CSP between A and C with at most 300ms") {
+            engine.setMaxDelay(300);
+            THEN("We find the path (A, D, E, C) with a cost of 3") {
+                REQUIRE(engine.solve());
+                const auto& path = engine.getPath();
+                REQUIRE(path.nodes == std::vector<std::size_t>{A, D, E, C});
+                REQUIRE(path.edges == std::vector<std::size_t>{2, 3, 4});
+                REQUIRE(path.cost == 3.0);
+                REQUIRE(path.resources[0] == 260.0);
+            }
+        }
+        WHEN("We search for the CSP between A and C with at most 100ms") {
+            engine.setMaxDelay(100);
+            THEN("We find the path (A, B, C) with a cost of 20") {
+                REQUIRE(engine.solve());
+                const auto& path = engine.getPath();
+                REQUIRE(path.nodes == std::vector<std::size_t>{A, B, C});
+                REQUIRE(path.edges == std::vector<std::size_t>{0, 1});
+                REQUIRE(path.cost == 20.0);
+                REQUIRE(path.resources[0] == 100.0);
+            }
+        }
+        WHEN("We search for the CSP between A and C with at most 99ms") {
+            engine.setMaxDelay(99);
+            THEN("We find no path") { REQUIRE(!engine.solve()); }
+        }
+    }
+}
+
+/**
+ * Check that _path goes from _s to _t through the edges of _network with the
+ * given cost and within _maxResources
+ */
+template <std::size_t NbResources>
+void checkPath(const CppRO::ConstrainedPath<NbResources>& _path,
+    const CppRO::ConstrainedShortestPathNetwork<NbResources>& _network,
+    const std::size_t _s, const std::size_t _t, const double _cost,
+    const std::array<double, NbResources>& _maxResources) {
+    REQUIRE(_path.cost == _cost);
+    REQUIRE(_path.nodes.front() == _s);
+    REQUIRE(_path.nodes.back() == _t);
+    REQUIRE(_path.edges.size() + 1 == _path.nodes.size());
+    double cost = 0.0;
+    std::array<double, NbResources> resources{};
+    for (std::size_t i = 0; i < _path.edges.size(); ++i) {
+        REQUIRE(_network.getTail(_path.edges[i]) == _path.nodes[i]);
+        REQUIRE(_network.getHead(_path.edges[i]) == _path.nodes[i + 1]);
+        cost += _network.getCost(_path.edges[i]);
+        for (std::size_t r = 0; r < NbResources; ++r) {
+            resources[r] += _network.getResources(_path.edges[i])[r];
+        }
+    }
+    REQUIRE(cost == _path.cost);
+    for (std::size_t r = 0; r < NbResources; ++r) {
+        REQUIRE(resources[r] == _path.resources[r]);
+        REQUIRE(resources[r] <= _maxResources[r]);
+    }
+}
+
+TEST_CASE("Exact CSP engines match an enumeration with two resources") {
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> valueDist(1, 20);
+    for (int instance = 0; instance < 30; ++instance) {
+        const auto graph = getRandomCspGraph(12, 40, gen);
+        const auto nbEdges = num_edges(graph);
+        std::vector<int> costs(nbEdges);
+        std::vector<int> delays(nbEdges);
+        std::vector<int> hops(nbEdges, 1);
+        for (std::size_t e = 0; e < nbEdges; ++e) {
+            costs[e] = valueDist(gen);
+            delays[e] = valueDist(gen);
+        }
+        CppRO::ConstrainedShortestPathNetwork<2> network(
+            graph, get(boost::edge_index, graph));
+        network.setCosts(costs);
+        network.setDelays(delays);
+        network.setResources(1, hops);
+        CppRO::LabelingConstrainedShortestPath<2> labeling(network);
+        CppRO::BidirectionalLabelingConstrainedShortestPath<2> bidirectional(
+            network);
+        CppRO::PulseConstrainedShortestPath<2> pulse(network);
+        const std::array<double, 2> maxResources{30.0, 4.0};
+        labeling.setMaxResources(maxResources);
+        bidirectional.setMaxResources(maxResources);
+        pulse.setMaxResources(maxResources);
+        std::vector<char> onPath(num_vertices(graph), 0);
+        for (std::size_t t = 1; t < num_vertices(graph); ++t) {
+            labeling.setNodePair(0, t);
+            bidirectional.setNodePair(0, t);
+            pulse.setNodePair(0, t);
+            const double expected = getBestPathCost(
+                network, 0, t, 0.0, {0.0, 0.0}, maxResources, onPath);
+            const bool isFeasible =
+                expected != std::numeric_limits<double>::infinity();
+            REQUIRE(labeling.solve() == isFeasible);
+            REQUIRE(bidirectional.solve() == isFeasible);
+            if (isFeasible) {
+                for (const int nbThreads : {1, 4}) {
+                    REQUIRE(pulse.solve(nbThreads));
+                    checkPath(pulse.getPath(), network, 0, t, expected,
+                        maxResources);
+                }
+                checkPath(
+                    labeling.getPath(), network, 0, t, expected, maxResources);
+                checkPath(bidirectional.getPath(), network, 0, t, expected,
+                    maxResources);
+                REQUIRE(bidirectional.getStatistics().joined > 0);
+            } else {
+                REQUIRE(!pulse.solve());
+            }
+        }
+    }
+}
+
+TEST_CASE("Bidirectional labeling counts its labels") {
+    // A direct edge 0 -> 1 and a detour 0 -> 2 -> 1, before 1 -> 3
+    const std::vector<std::pair<std::size_t, std::size_t>> edgeList{
+        {0, 1}, {0, 2}, {2, 1}, {1, 3}};
+    const std::vector<std::size_t> edgeIndex{0, 1, 2, 3};
+    const CspGraph graph(
+        edgeList.begin(), edgeList.end(), edgeIndex.begin(), 4);
+    CppRO::ConstrainedShortestPathNetwork<> network(
+        graph, get(boost::edge_index, graph));
+    network.setDelays(std::vector<double>{1.0, 5.0, 5.0, 1.0});
+    CppRO::BidirectionalLabelingConstrainedShortestPath<> labeling(network);
+    labeling.setNodePair(0, 3);
+    labeling.setMaxDelay(100);
+
+    // A cheaper detour is a trade-off, not dominated
+    network.setCosts(std::vector<double>{4.0, 1.0, 1.0, 1.0});
+    REQUIRE(labeling.solve());
+    const auto tradeOff = labeling.getStatistics();
+    REQUIRE(tradeOff.forwardLabels > 0);
+    REQUIRE(tradeOff.backwardLabels > 0);
+    REQUIRE(tradeOff.dominated == 0);
+
+    // A more expensive detour is dominated by the direct edge
+    network.setCosts(std::vector<double>{4.0, 3.0, 3.0, 1.0});
+    REQUIRE(labeling.solve());
+    REQUIRE(labeling.getPath().edges == std::vector<std::size_t>{0, 3});
+    REQUIRE(labeling.getStatistics().dominated > tradeOff.dominated);
+}
+
+TEST_CASE("Batched queries keep the order of the queries") {
+    constexpr auto A = 0;
+    constexpr auto C = 2;
+    const auto testGraph = getScenarioGraph();
+    CppRO::ConstrainedShortestPathNetwork<> network(
+        testGraph, get(boost::edge_index, testGraph));
+    network.setDelays(SCENARIO_DELAYS);
+    network.setCosts(SCENARIO_COSTS);
+    CppRO::BatchConstrainedShortestPath<> batch(network);
+    CppRO::LabelingConstrainedShortestPath<> labeling(network);
+    labeling.setNodePair(A, C);
+
+    // The infeasible query sits between two feasible ones
+    const auto paths =
+        batch.solve({{A, C, {100}}, {A, C, {99}}, {A, C, {300}}});
+    REQUIRE(paths.size() == 3);
+    const auto checkQuery = [&](const auto& _path, const double _maxDelay) {
+        REQUIRE(_path.has_value());
+        labeling.setMaxDelay(_maxDelay);
+        REQUIRE(labeling.solve());
+        REQUIRE(_path->nodes == labeling.getPath().nodes);
+        REQUIRE(_path->cost == labeling.getPath().cost);
+    };
+    checkQuery(paths[0], 100);
+    REQUIRE(!paths[1].has_value());
+    checkQuery(paths[2], 300);
+}
+
+TEST_CASE("Batched queries match one labeling per query") {
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> valueDist(1, 20);
+    const auto graph = getRandomCspGraph(30, 120, gen);
+    const auto nbEdges = num_edges(graph);
+    std::vector<int> costs(nbEdges);
+    std::vector<int> delays(nbEdges);
+    for (std::size_t e = 0; e < nbEdges; ++e) {
+        costs[e] = valueDist(gen);
+        delays[e] = valueDist(gen);
+    }
+    CppRO::ConstrainedShortestPathNetwork<> network(
+        graph, get(boost::edge_index, graph));
+    network.setCosts(costs);
+    network.setDelays(delays);
+
+    // Few targets, so that several queries share their bounds
+    std::uniform_int_distribution<std::size_t> sourceDist(0, 29);
+    std::uniform_int_distribution<std::size_t> targetDist(0, 4);
+    std::uniform_int_distribution<int> maxDelayDist(10, 60);
+    std::vector<CppRO::ConstrainedShortestPathQuery<>> queries;
+    for (int i = 0; i < 100; ++i) {
+        queries.push_back({sourceDist(gen), targetDist(gen),
+            {static_cast<double>(maxDelayDist(gen))}});
+    }
+
+    CppRO::LabelingConstrainedShortestPath<> labeling(network);
+    CppRO::BatchConstrainedShortestPath<> batch(network);
+    for (const int nbThreads : {1, 4}) {
+        const auto paths = batch.solve(queries, nbThreads);
+        REQUIRE(paths.size() == queries.size());
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            labeling.setNodePair(queries[i].source, queries[i].target);
+            labeling.setMaxResources(queries[i].maxResources);
+            REQUIRE(labeling.solve() == paths[i].has_value());
+            if (paths[i]) {
+                checkPath(*paths[i], network, queries[i].source,
+                    queries[i].target, labeling.getPath().cost,
+                    queries[i].maxResources);
+            }
+        }
+    }
+}